@@ -0,0 +1,62 @@
+// Times a few JavaScript kernels run in a page, to compare JIT settings:
+//   phantomjs examples/jsbench.js
+//   phantomjs --dfg-jit=true examples/jsbench.js
+// On Linux the DFG JIT is only there when QtWebKit was built with ENABLE_DFG_JIT=1;
+// other builds refuse --dfg-jit=true.
+
+var page = require('webpage').create(),
+    system = require('system'),
+    rounds = system.args.length > 1 ? parseInt(system.args[1], 10) : 5;
+
+var results = page.evaluate(function (rounds) {
+    // Small straight-line functions, called from hot loops: what the DFG JIT compiles today
+    function mix(a, b) { return (a * 31 + b) | 0; }
+    function hypot2(x, y) { return x * x + y * y; }
+    function getX(p) { return p.x; }
+    function makePoint(x, y) { return { x: x, y: y }; }
+
+    var kernels = {
+        'integer mixing': function () {
+            var h = 0;
+            for (var i = 0; i < 3000000; ++i) {
+                h = mix(h, i);
+            }
+            return h;
+        },
+        'floating point': function () {
+            var sum = 0;
+            for (var i = 0; i < 3000000; ++i) {
+                sum += hypot2(i * 0.5, i * 0.25);
+            }
+            return sum;
+        },
+        'property access': function () {
+            var points = [], sum = 0, i;
+            for (i = 0; i < 1000; ++i) {
+                points.push(makePoint(i, -i));
+            }
+            for (i = 0; i < 3000000; ++i) {
+                sum += getX(points[i % 1000]);
+            }
+            return sum;
+        }
+    };
+
+    var results = {}, name, round, start, best;
+    for (name in kernels) {
+        best = Infinity;
+        for (round = 0; round < rounds; ++round) {
+            start = Date.now();
+            kernels[name]();
+            best = Math.min(best, Date.now() - start);
+        }
+        results[name] = best;
+    }
+    return results;
+}, rounds);
+
+console.log('Best of ' + rounds + ' rounds (ms):');
+for (var name in results) {
+    console.log('    ' + name + ': ' + results[name]);
+}
+phantom.exit();
@@ -0,0 +1,57 @@
+// Times JSON.parse and JSON.stringify on typical payloads in a page:
+//   phantomjs examples/jsonbench.js [rounds]
+
+var page = require('webpage').create(),
+    system = require('system'),
+    rounds = system.args.length > 1 ? parseInt(system.args[1], 10) : 5;
+
+var results = page.evaluate(function (rounds) {
+    var records = [], i;
+    for (i = 0; i < 20000; ++i) {
+        records.push({
+            id: i,
+            name: 'record number ' + i,
+            score: i * 0.5,
+            active: i % 2 === 0,
+            tags: ['alpha', 'beta', 'gamma'],
+            position: { x: i, y: -i }
+        });
+    }
+    var recordsText = JSON.stringify(records);
+
+    var numbers = [];
+    for (i = 0; i < 200000; ++i) {
+        numbers.push(i);
+    }
+    var numbersText = JSON.stringify(numbers);
+
+    var longString = new Array(20001).join('some text without escapes ');
+    var longStringText = JSON.stringify([longString]);
+
+    var kernels = {
+        'parse records': function () { return JSON.parse(recordsText); },
+        'parse numbers': function () { return JSON.parse(numbersText); },
+        'parse long string': function () { return JSON.parse(longStringText); },
+        'stringify records': function () { return JSON.stringify(records); },
+        'stringify numbers': function () { return JSON.stringify(numbers); },
+        'stringify long string': function () { return JSON.stringify(longString); }
+    };
+
+    var results = {}, name, round, start, best;
+    for (name in kernels) {
+        best = Infinity;
+        for (round = 0; round < rounds; ++round) {
+            start = Date.now();
+            kernels[name]();
+            best = Math.min(best, Date.now() - start);
+        }
+        results[name] = best;
+    }
+    return results;
+}, rounds);
+
+console.log('Best of ' + rounds + ' rounds (ms):');
+for (var name in results) {
+    console.log('    ' + name + ': ' + results[name]);
+}
+phantom.exit();
@@ -320,9 +320,14 @@ phantom.callback = function(callback) {
         mainFilename = joinPath(cwd, basename(require('system').args[0]) || 'repl');
         mainModule._setFilename(mainFilename);
 
-        // include CoffeeScript which takes care of adding .coffee extension (only if not in Webdriver mode)
+        // CoffeeScript takes care of the .coffee extension, but it's big: only load it
+        // when the first .coffee module is required (and never in Webdriver mode)
         if (!phantom.webdriverMode) {
-            require('_coffee-script');
+            extensions['.coffee'] = function(module, filename) {
+                delete extensions['.coffee'];
+                mainModule.require('_coffee-script');
+                extensions['.coffee'](module, filename);
+            };
         }
     }());
 }());
@@ -29,6 +29,23 @@
 
 #include "childprocess.h"
 
+#include <QCoreApplication>
+#include <QSocketNotifier>
+
+#ifdef Q_OS_UNIX
+#include <stdlib.h>
+#include <unistd.h>
+#endif
+
+#include "terminal.h"
+
+// Set in the environment of the PhantomJS started by `child_process.fork()`
+#define FORK_ENV_VARIABLE       "PHANTOMJS_FORKED"
+// Prefix of the stdout lines carrying a message, rather than the output of the child
+#define FORK_MESSAGE_PREFIX     '\x1e'
+// Above this many bytes waiting to be written to stdin, writers are asked to wait for "drain"
+#define STDIN_HIGH_WATER_MARK   (64 * 1024)
+
 //
 // ChildProcessContext
 //
@@ -36,11 +53,19 @@
 ChildProcessContext::ChildProcessContext(QObject *parent)
     : QObject(parent)
     , m_proc(this)
+    , m_forked(false)
+    , m_binary(false)
+    , m_stdoutPaused(false)
+    , m_stderrPaused(false)
+    , m_stdinNeedsDrain(false)
+    , m_exitPending(false)
+    , m_exitCode(0)
 {
     connect(&m_proc, SIGNAL(readyReadStandardOutput()), this, SLOT(_readyReadStandardOutput()));
     connect(&m_proc, SIGNAL(readyReadStandardError()), this, SLOT(_readyReadStandardError()));
     connect(&m_proc, SIGNAL(finished(int, QProcess::ExitStatus)), this, SLOT(_finished(int, QProcess::ExitStatus)));
     connect(&m_proc, SIGNAL(error(QProcess::ProcessError)), this, SLOT(_error(QProcess::ProcessError)));
+    connect(&m_proc, SIGNAL(bytesWritten(qint64)), this, SLOT(_bytesWritten()));
 }
 
 ChildProcessContext::~ChildProcessContext()
@@ -76,6 +101,11 @@ void ChildProcessContext::_setEncoding(const QString &encoding)
     m_encoding.setEncoding(encoding);
 }
 
+void ChildProcessContext::_setBinary(const bool binary)
+{
+    m_binary = binary;
+}
+
 // This is affected by [QTBUG-5990](https://bugreports.qt-project.org/browse/QTBUG-5990).
 // `QProcess` doesn't properly handle the situations of `cmd` not existing or
 // failing to start...
@@ -86,42 +116,213 @@ bool ChildProcessContext::_start(const QString &cmd, const QStringList &args)
     return m_proc.waitForStarted(1000);
 }
 
+bool ChildProcessContext::_fork(const QString &modulePath, const QStringList &args)
+{
+    m_forked = true;
+
+    QStringList env = QProcess::systemEnvironment();
+    env << QString("%1=1").arg(FORK_ENV_VARIABLE);
+    m_proc.setEnvironment(env);
+
+    return _start(QCoreApplication::applicationFilePath(), QStringList(modulePath) + args);
+}
+
+bool ChildProcessContext::_send(const QString &message)
+{
+    if (!m_forked || m_proc.state() != QProcess::Running) {
+        return false;
+    }
+
+    // Messages are JSON: they never contain a raw line break
+    QByteArray line = message.toUtf8();
+    line.append('\n');
+    return m_proc.write(line) == line.size();
+}
+
+bool ChildProcessContext::_writeStdin(const QVariant &chunk, const QString &encoding)
+{
+    QByteArray bytes;
+    if (chunk.type() == QVariant::ByteArray) {
+        bytes = chunk.toByteArray();
+    } else if ("base64" == encoding) {
+        bytes = QByteArray::fromBase64(chunk.toString().toLatin1());
+    } else if ("binary" == encoding) {
+        bytes = chunk.toString().toLatin1();
+    } else {
+        bytes = m_encoding.encode(chunk.toString());
+    }
+
+    if (m_proc.write(bytes) != bytes.size()) {
+        return false;
+    }
+
+    if (m_proc.bytesToWrite() >= STDIN_HIGH_WATER_MARK) {
+        m_stdinNeedsDrain = true;
+        return false;
+    }
+    return true;
+}
+
+void ChildProcessContext::_endStdin()
+{
+    // Pending data is still written before the channel is closed
+    m_proc.closeWriteChannel();
+}
+
+void ChildProcessContext::_pauseOutput(const QString &streamName)
+{
+    if ("stderr" == streamName) {
+        m_stderrPaused = true;
+    } else {
+        m_stdoutPaused = true;
+    }
+}
+
+void ChildProcessContext::_resumeOutput(const QString &streamName)
+{
+    // Deliver what was kept while paused
+    if ("stderr" == streamName) {
+        m_stderrPaused = false;
+        _readyReadStandardError();
+    } else {
+        m_stdoutPaused = false;
+        _readyReadStandardOutput();
+    }
+    _emitExitWhenDrained();
+}
+
 // private slots:
 
 void ChildProcessContext::_readyReadStandardOutput()
 {
+    if (m_stdoutPaused) {
+        return;
+    }
+
     QByteArray bytes = m_proc.readAllStandardOutput();
-    emit stdoutData(m_encoding.decode(bytes));
+    if (bytes.isEmpty()) {
+        return;
+    }
+
+    if (!m_forked) {
+        if (m_binary) {
+            emit stdoutBytes(bytes);
+        } else {
+            emit stdoutData(m_encoding.decode(bytes));
+        }
+        return;
+    }
+
+    // Messages are whole lines, so the output of a forked child is forwarded line by line
+    m_stdoutBuffer.append(bytes);
+    int start = 0, end;
+    while ((end = m_stdoutBuffer.indexOf('\n', start)) != -1) {
+        QByteArray line = m_stdoutBuffer.mid(start, end - start + 1);
+        if (line.startsWith(FORK_MESSAGE_PREFIX)) {
+            line.chop(1);
+            emit message(QString::fromUtf8(line.constData() + 1, line.size() - 1));
+        } else {
+            emit stdoutData(m_encoding.decode(line));
+        }
+        start = end + 1;
+    }
+    m_stdoutBuffer.remove(0, start);
 }
 
 void ChildProcessContext::_readyReadStandardError()
 {
+    if (m_stderrPaused) {
+        return;
+    }
+
     QByteArray bytes = m_proc.readAllStandardError();
-    emit stderrData(m_encoding.decode(bytes));
+    if (bytes.isEmpty()) {
+        return;
+    }
+
+    if (m_binary) {
+        emit stderrBytes(bytes);
+    } else {
+        emit stderrData(m_encoding.decode(bytes));
+    }
 }
 
 void ChildProcessContext::_finished(const int exitCode, const QProcess::ExitStatus exitStatus)
 {
     Q_UNUSED(exitStatus)
 
-    emit exit(exitCode);
+    m_exitCode = exitCode;
+    m_exitPending = true;
+    _emitExitWhenDrained();
+}
+
+void ChildProcessContext::_bytesWritten()
+{
+    if (m_stdinNeedsDrain && 0 == m_proc.bytesToWrite()) {
+        m_stdinNeedsDrain = false;
+        emit stdinDrain();
+    }
 }
 
 void ChildProcessContext::_error(const QProcess::ProcessError error)
 {
-    Q_UNUSED(error)
+    // A child that started, crashed or not, also gets "finished", which emits "exit"
+    if (error != QProcess::FailedToStart || m_exitPending) {
+        return;
+    }
+
+    m_exitCode = m_proc.exitCode();
+    m_exitPending = true;
+    _emitExitWhenDrained();
+}
+
+// private:
+
+void ChildProcessContext::_emitExitWhenDrained()
+{
+    // Output kept while paused goes out before "exit": wait for the streams to be resumed
+    if (!m_exitPending || m_stdoutPaused || m_stderrPaused) {
+        return;
+    }
+
+    _readyReadStandardOutput();
+    _readyReadStandardError();
+    // Whatever the child wrote last goes out too, even without a final line break
+    if (!m_stdoutBuffer.isEmpty()) {
+        emit stdoutData(m_encoding.decode(m_stdoutBuffer));
+        m_stdoutBuffer.clear();
+    }
 
-    emit exit(m_proc.exitCode());
+    m_exitPending = false;
+    emit exit(m_exitCode);
 }
 
 
+#ifdef Q_OS_UNIX
+// Reads the variable once, then drops it from the environment: processes started
+// from here inherit it, and must not believe they were forked too
+static bool readForkEnvironment()
+{
+    bool forked = qgetenv(FORK_ENV_VARIABLE) == "1";
+    ::unsetenv(FORK_ENV_VARIABLE);
+    return forked;
+}
+#endif
+
 //
 // ChildProcess
 //
 
 ChildProcess::ChildProcess(QObject *parent)
     : QObject(parent)
+    , m_parentNotifier(0)
 {
+#ifdef Q_OS_UNIX
+    if (isForkedProcess()) {
+        m_parentNotifier = new QSocketNotifier(STDIN_FILENO, QSocketNotifier::Read, this);
+        connect(m_parentNotifier, SIGNAL(activated(int)), this, SLOT(_readyReadParent()));
+    }
+#endif
 }
 
 ChildProcess::~ChildProcess()
@@ -130,7 +331,56 @@ ChildProcess::~ChildProcess()
 
 // public:
 
+bool ChildProcess::isForked() const
+{
+    return m_parentNotifier != 0;
+}
+
+bool ChildProcess::isForkedProcess()
+{
+#ifdef Q_OS_UNIX
+    static const bool forked = readForkEnvironment();
+    return forked;
+#else
+    return false;
+#endif
+}
+
 QObject *ChildProcess::_createChildProcessContext()
 {
     return new ChildProcessContext(this);
 }
+
+bool ChildProcess::_sendToParent(const QString &message)
+{
+    if (!isForked()) {
+        return false;
+    }
+
+    // Going through the Terminal keeps messages and console output in order
+    Terminal::instance()->cout(QString(FORK_MESSAGE_PREFIX) + message);
+    return true;
+}
+
+// private slots:
+
+void ChildProcess::_readyReadParent()
+{
+#ifdef Q_OS_UNIX
+    char buffer[4096];
+    ssize_t size = ::read(STDIN_FILENO, buffer, sizeof(buffer));
+    if (size <= 0) {
+        // The parent went away: nothing more will come
+        m_parentNotifier->setEnabled(false);
+        return;
+    }
+
+    m_parentBuffer.append(buffer, size);
+    int start = 0, end;
+    while ((end = m_parentBuffer.indexOf('\n', start)) != -1) {
+        emit _parentMessage(QString::fromUtf8(m_parentBuffer.constData() + start, end - start));
+        start = end + 1;
+    }
+    m_parentBuffer.remove(0, start);
+#endif
+}
@@ -33,6 +33,8 @@
 #include <QObject>
 #include <QProcess>
 
+class QSocketNotifier;
+
 #ifdef Q_OS_WIN32
 #include <QtCore/qt_windows.h>
 #endif
@@ -55,10 +57,44 @@ public:
     Q_INVOKABLE void kill(const QString &signal = "SIGTERM");
 
     Q_INVOKABLE void _setEncoding(const QString &encoding);
+    /**
+     * In binary mode, output is delivered as raw bytes through `stdoutBytes` and `stderrBytes`
+     * rather than decoded text through `stdoutData` and `stderrData`.
+     */
+    Q_INVOKABLE void _setBinary(const bool binary);
     Q_INVOKABLE bool _start(const QString &cmd, const QStringList &args);
+    /**
+     * Start another PhantomJS running `modulePath`, with a message channel:
+     * messages are sent on its stdin, and received from its stdout.
+     *
+     * @see ChildProcess for the other end of the channel
+     */
+    Q_INVOKABLE bool _fork(const QString &modulePath, const QStringList &args);
+    Q_INVOKABLE bool _send(const QString &message);
+
+    /**
+     * Write a chunk to the stdin of the child.
+     * Byte arrays (and typed arrays) are written as they are; strings are encoded
+     * with `encoding` ("base64", "binary") or with the encoding of the process.
+     *
+     * @return Boolean "false" once too much data is waiting to be written:
+     *         stop writing until `stdinDrain` is emitted
+     */
+    Q_INVOKABLE bool _writeStdin(const QVariant &chunk, const QString &encoding = QString());
+    Q_INVOKABLE void _endStdin();
+
+    /**
+     * Stop/restart delivering output: in the meantime it is kept by the process buffers.
+     */
+    Q_INVOKABLE void _pauseOutput(const QString &streamName);
+    Q_INVOKABLE void _resumeOutput(const QString &streamName);
 
 signals:
     void exit(const int code) const;
+    /**
+     * For emulating `child.on("message", function (message) {})`
+     */
+    void message(const QString &message) const;
 
     /**
      * For emulating `child.stdout.on("data", function (data) {})`
@@ -68,30 +104,72 @@ signals:
      * For emulating `child.stderr.on("data", function (data) {})`
      */
     void stderrData(const QString &data) const;
+    /**
+     * Binary mode counterparts of `stdoutData` and `stderrData`
+     */
+    void stdoutBytes(const QByteArray &data) const;
+    void stderrBytes(const QByteArray &data) const;
+    /**
+     * For emulating `child.stdin.on("drain", function () {})`
+     */
+    void stdinDrain() const;
 
 private slots:
     void _readyReadStandardOutput();
     void _readyReadStandardError();
     void _error(const QProcess::ProcessError error);
     void _finished(const int exitCode, const QProcess::ExitStatus exitStatus);
+    void _bytesWritten();
 
 private:
+    void _emitExitWhenDrained();
+
     QProcess m_proc;
     Encoding m_encoding;
+    bool m_forked;
+    bool m_binary;
+    bool m_stdoutPaused;
+    bool m_stderrPaused;
+    bool m_stdinNeedsDrain;
+    bool m_exitPending;
+    int m_exitCode;
+    QByteArray m_stdoutBuffer;
 };
 
 /**
- * Helper class for child_process module
+ * Helper class for child_process module.
+ *
+ * In a PhantomJS started by `child_process.fork()`, it is also the child end
+ * of the message channel (only available on Unix).
  */
 class ChildProcess : public QObject
 {
     Q_OBJECT
+    Q_PROPERTY(bool _forked READ isForked)
 
 public:
     explicit ChildProcess(QObject *parent = 0);
     virtual ~ChildProcess();
 
+    bool isForked() const;
+    /**
+     * Whether this process was started by `child_process.fork()`: its stdin
+     * is then the message channel from the parent, read by ChildProcess alone.
+     */
+    static bool isForkedProcess();
+
     Q_INVOKABLE QObject *_createChildProcessContext();
+    Q_INVOKABLE bool _sendToParent(const QString &message);
+
+signals:
+    void _parentMessage(const QString &message) const;
+
+private slots:
+    void _readyReadParent();
+
+private:
+    QSocketNotifier *m_parentNotifier;
+    QByteArray m_parentBuffer;
 };
 
 #endif // CHILDPROCESS_H
@@ -216,18 +216,29 @@ static const struct QCommandLineConfigEntry flags[] =
     { QCommandLine::Option, '\0', "config", "Specifies JSON-formatted configuration file", QCommandLine::Optional },
     { QCommandLine::Option, '\0', "debug", "Prints additional warning and debug message: 'true' or 'false' (default)", QCommandLine::Optional },
     { QCommandLine::Option, '\0', "disk-cache", "Enables disk cache: 'true' or 'false' (default)", QCommandLine::Optional },
+    { QCommandLine::Option, '\0', "dfg-jit", "Enables the DFG optimizing JavaScript JIT, refused by builds without it (Linux x86_64 needs ENABLE_DFG_JIT=1; always on for Mac OS X): 'true' or 'false' (default)", QCommandLine::Optional },
+    { QCommandLine::Option, '\0', "gc-generational", "Collects the JavaScript heap by generations, disabling the DFG JIT; refused by builds without ENABLE_GGC=1: 'true' or 'false' (default)", QCommandLine::Optional },
+    { QCommandLine::Option, '\0', "gc-marking-threads", "Number of threads marking the JavaScript heap during garbage collection, above 1 refused by builds without ENABLE_PARALLEL_GC=1: '1' (default) to '8'", QCommandLine::Optional },
+    { QCommandLine::Option, '\0', "image-decoding-threads", "Number of threads decoding images ahead of their first paint, '0' decodes them when painted; default is the number of CPU cores", QCommandLine::Optional },
     { QCommandLine::Option, '\0', "ignore-ssl-errors", "Ignores SSL errors (expired/self-signed certificate errors): 'true' or 'false' (default)", QCommandLine::Optional },
     { QCommandLine::Option, '\0', "load-images", "Loads all inlined images: 'true' (default) or 'false'", QCommandLine::Optional },
     { QCommandLine::Option, '\0', "local-storage-path", "Specifies the location for offline local storage", QCommandLine::Optional },
     { QCommandLine::Option, '\0', "local-storage-quota", "Sets the maximum size of the offline local storage (in KB)", QCommandLine::Optional },
     { QCommandLine::Option, '\0', "local-to-remote-url-access", "Allows local content to access remote URL: 'true' or 'false' (default)", QCommandLine::Optional },
+    { QCommandLine::Option, '\0', "max-decoded-image-area", "Decodes still images of more pixels than this scaled down to about this many pixels, but never smaller than they are drawn; default is '0' (no limit)", QCommandLine::Optional },
     { QCommandLine::Option, '\0', "max-disk-cache-size", "Limits the size of the disk cache (in KB)", QCommandLine::Optional },
+    { QCommandLine::Option, '\0', "max-pages-in-cache", "Number of visited pages kept in memory to go back and forward to, default is '0'", QCommandLine::Optional },
+    { QCommandLine::Option, '\0', "memory-cache-size", "Limits the size of the memory cache of decoded resources (in KB), default is '8192'", QCommandLine::Optional },
+    { QCommandLine::Option, '\0', "memory-cache-dead-size", "Limits how much of the memory cache resources no page uses may take (in KB), default is the whole cache", QCommandLine::Optional },
     { QCommandLine::Option, '\0', "output-encoding", "Sets the encoding for the terminal output, default is 'utf8'", QCommandLine::Optional },
+    { QCommandLine::Option, '\0', "regexp-cache-size", "Number of compiled regular expressions kept for reuse, default is '1024'", QCommandLine::Optional },
+    { QCommandLine::Option, '\0', "regexp-cache-max-pattern-length", "Length of the longest regular expression kept for reuse, default is '4096'", QCommandLine::Optional },
     { QCommandLine::Option, '\0', "remote-debugger-port", "Starts the script in a debug harness and listens on the specified port", QCommandLine::Optional },
     { QCommandLine::Option, '\0', "remote-debugger-autorun", "Runs the script in the debugger immediately: 'true' or 'false' (default)", QCommandLine::Optional },
     { QCommandLine::Option, '\0', "proxy", "Sets the proxy server, e.g. '--proxy=http://proxy.company.com:8080'", QCommandLine::Optional },
     { QCommandLine::Option, '\0', "proxy-auth", "Provides authentication information for the proxy, e.g. ''-proxy-auth=username:password'", QCommandLine::Optional },
     { QCommandLine::Option, '\0', "proxy-type", "Specifies the proxy type, 'http' (default), 'none' (disable completely), or 'socks5'", QCommandLine::Optional },
+    { QCommandLine::Option, '\0', "script-cache-path", "Keeps what the JavaScript parser learns about page scripts in this directory, to load them faster in later runs", QCommandLine::Optional },
     { QCommandLine::Option, '\0', "script-encoding", "Sets the encoding used for the starting script, default is 'utf8'", QCommandLine::Optional },
     { QCommandLine::Option, '\0', "web-security", "Enables web security, 'true' (default) or 'false'", QCommandLine::Optional },
     { QCommandLine::Option, '\0', "ssl-protocol", "Sets the SSL protocol (supported protocols: 'SSLv3' (default), 'SSLv2', 'TLSv1', 'any')", QCommandLine::Optional },
@@ -236,6 +247,8 @@ static const struct QCommandLineConfigEntry flags[] =
     { QCommandLine::Option, '\0', "webdriver-logfile", "File where to write the WebDriver's Log (default 'none') (NOTE: needs '--webdriver') ", QCommandLine::Optional },
     { QCommandLine::Option, '\0', "webdriver-loglevel", "WebDriver Logging Level: (supported: 'ERROR', 'WARN', 'INFO', 'DEBUG') (default 'INFO') (NOTE: needs '--webdriver') ", QCommandLine::Optional },
     { QCommandLine::Option, '\0', "webdriver-selenium-grid-hub", "URL to the Selenium Grid HUB: 'URL_TO_HUB' (default 'none') (NOTE: needs '--webdriver') ", QCommandLine::Optional },
+    { QCommandLine::Option, '\0', "fork-server", "Starts a server forking warm instances on the given local socket path (Unix only)", QCommandLine::Optional },
+    { QCommandLine::Option, '\0', "fork-client", "Runs the script in a worker of the fork server listening on the given local socket path, and exits with its exit code", QCommandLine::Optional },
     { QCommandLine::Param, '\0', "script", "Script", QCommandLine::Flags(QCommandLine::Optional|QCommandLine::ParameterFence)},
     { QCommandLine::Param, '\0', "argument", "Script argument", QCommandLine::OptionalMultiple },
     { QCommandLine::Switch, 'w', "wd", "Equivalent to '--webdriver' option above", QCommandLine::Optional },
@@ -371,6 +384,17 @@ void Config::setOfflineStoragePath(const QString &value)
     m_offlineStoragePath = dir.absolutePath();
 }
 
+QString Config::scriptCachePath() const
+{
+    return m_scriptCachePath;
+}
+
+void Config::setScriptCachePath(const QString &value)
+{
+    QDir dir(value);
+    m_scriptCachePath = dir.absolutePath();
+}
+
 int Config::offlineStorageDefaultQuota() const
 {
     return m_offlineStorageDefaultQuota;
@@ -391,6 +415,106 @@ void Config::setDiskCacheEnabled(const bool value)
     m_diskCacheEnabled = value;
 }
 
+bool Config::dfgJitEnabled() const
+{
+    return m_dfgJitEnabled;
+}
+
+void Config::setDfgJitEnabled(const bool value)
+{
+    m_dfgJitEnabled = value;
+}
+
+int Config::gcMarkingThreads() const
+{
+    return m_gcMarkingThreads;
+}
+
+void Config::setGcMarkingThreads(int gcMarkingThreads)
+{
+    m_gcMarkingThreads = gcMarkingThreads;
+}
+
+bool Config::gcGenerational() const
+{
+    return m_gcGenerational;
+}
+
+void Config::setGcGenerational(const bool value)
+{
+    m_gcGenerational = value;
+}
+
+int Config::imageDecodingThreads() const
+{
+    return m_imageDecodingThreads;
+}
+
+void Config::setImageDecodingThreads(int imageDecodingThreads)
+{
+    m_imageDecodingThreads = imageDecodingThreads;
+}
+
+int Config::maxDecodedImageArea() const
+{
+    return m_maxDecodedImageArea;
+}
+
+void Config::setMaxDecodedImageArea(int maxDecodedImageArea)
+{
+    m_maxDecodedImageArea = maxDecodedImageArea;
+}
+
+int Config::memoryCacheSize() const
+{
+    return m_memoryCacheSize;
+}
+
+void Config::setMemoryCacheSize(int memoryCacheSize)
+{
+    m_memoryCacheSize = memoryCacheSize;
+}
+
+int Config::memoryCacheDeadSize() const
+{
+    return m_memoryCacheDeadSize;
+}
+
+void Config::setMemoryCacheDeadSize(int memoryCacheDeadSize)
+{
+    m_memoryCacheDeadSize = memoryCacheDeadSize;
+}
+
+int Config::maxPagesInCache() const
+{
+    return m_maxPagesInCache;
+}
+
+void Config::setMaxPagesInCache(int maxPagesInCache)
+{
+    m_maxPagesInCache = maxPagesInCache;
+}
+
+int Config::regExpCacheSize() const
+{
+    return m_regExpCacheSize;
+}
+
+void Config::setRegExpCacheSize(int regExpCacheSize)
+{
+    m_regExpCacheSize = regExpCacheSize;
+}
+
+int Config::regExpCacheMaxPatternLength() const
+{
+    return m_regExpCacheMaxPatternLength;
+}
+
+void Config::setRegExpCacheMaxPatternLength(int regExpCacheMaxPatternLength)
+{
+    m_regExpCacheMaxPatternLength = regExpCacheMaxPatternLength;
+}
+
 int Config::maxDiskCacheSize() const
 {
     return m_maxDiskCacheSize;
@@ -673,14 +797,55 @@ QString Config::webdriverSeleniumGridHub() const
     return m_webdriverSeleniumGridHub;
 }
 
+void Config::setForkServer(const QString &socketPath)
+{
+    m_forkServer = socketPath;
+}
+
+QString Config::forkServer() const
+{
+    return m_forkServer;
+}
+
+bool Config::isForkServerMode() const
+{
+    return !m_forkServer.isEmpty();
+}
+
+void Config::setForkClient(const QString &socketPath)
+{
+    m_forkClient = socketPath;
+}
+
+QString Config::forkClient() const
+{
+    return m_forkClient;
+}
+
+bool Config::isForkClientMode() const
+{
+    return !m_forkClient.isEmpty();
+}
+
 // private:
 void Config::resetToDefaults()
 {
     m_autoLoadImages = true;
     m_cookiesFile = QString();
     m_offlineStoragePath = QString();
+    m_scriptCachePath = QString();
     m_offlineStorageDefaultQuota = -1;
     m_diskCacheEnabled = false;
+    m_dfgJitEnabled = false;
+    m_gcMarkingThreads = 1;
+    m_gcGenerational = false;
+    m_imageDecodingThreads = -1;
+    m_maxDecodedImageArea = 0;
+    m_memoryCacheSize = -1;
+    m_memoryCacheDeadSize = -1;
+    m_maxPagesInCache = -1;
+    m_regExpCacheSize = -1;
+    m_regExpCacheMaxPatternLength = -1;
     m_maxDiskCacheSize = -1;
     m_ignoreSslErrors = false;
     m_localToRemoteUrlAccessEnabled = false;
@@ -710,6 +875,8 @@ void Config::resetToDefaults()
     m_webdriverLogFile = QString();
     m_webdriverLogLevel = "INFO";
     m_webdriverSeleniumGridHub = QString();
+    m_forkServer = QString();
+    m_forkClient = QString();
 }
 
 void Config::setProxyAuthPass(const QString &value)
@@ -769,6 +936,8 @@ void Config::handleOption(const QString &option, const QVariant &value)
     QStringList booleanFlags;
     booleanFlags << "debug";
     booleanFlags << "disk-cache";
+    booleanFlags << "dfg-jit";
+    booleanFlags << "gc-generational";
     booleanFlags << "ignore-ssl-errors";
     booleanFlags << "load-images";
     booleanFlags << "local-to-remote-url-access";
@@ -805,6 +974,10 @@ void Config::handleOption(const QString &option, const QVariant &value)
         setDiskCacheEnabled(boolValue);
     }
 
+    if (option == "dfg-jit") {
+        setDfgJitEnabled(boolValue);
+    }
+
     if (option == "ignore-ssl-errors") {
         setIgnoreSslErrors(boolValue);
     }
@@ -813,6 +986,10 @@ void Config::handleOption(const QString &option, const QVariant &value)
         setAutoLoadImages(boolValue);
     }
 
+    if (option == "script-cache-path") {
+        setScriptCachePath(value.toString());
+    }
+
     if (option == "local-storage-path") {
         setOfflineStoragePath(value.toString());
     }
@@ -825,14 +1002,50 @@ void Config::handleOption(const QString &option, const QVariant &value)
         setLocalToRemoteUrlAccessEnabled(boolValue);
     }
 
+    if (option == "gc-generational") {
+        setGcGenerational(boolValue);
+    }
+
+    if (option == "gc-marking-threads") {
+        setGcMarkingThreads(value.toInt());
+    }
+
+    if (option == "image-decoding-threads") {
+        setImageDecodingThreads(value.toInt());
+    }
+
+    if (option == "max-decoded-image-area") {
+        setMaxDecodedImageArea(value.toInt());
+    }
+
     if (option == "max-disk-cache-size") {
         setMaxDiskCacheSize(value.toInt());
     }
 
+    if (option == "max-pages-in-cache") {
+        setMaxPagesInCache(value.toInt());
+    }
+
+    if (option == "memory-cache-size") {
+        setMemoryCacheSize(value.toInt());
+    }
+
+    if (option == "memory-cache-dead-size") {
+        setMemoryCacheDeadSize(value.toInt());
+    }
+
     if (option == "output-encoding") {
         setOutputEncoding(value.toString());
     }
 
+    if (option == "regexp-cache-size") {
+        setRegExpCacheSize(value.toInt());
+    }
+
+    if (option == "regexp-cache-max-pattern-length") {
+        setRegExpCacheMaxPatternLength(value.toInt());
+    }
+
     if (option == "remote-debugger-autorun") {
         setRemoteDebugAutorun(boolValue);
     }
@@ -879,6 +1092,12 @@ void Config::handleOption(const QString &option, const QVariant &value)
     if (option == "webdriver-selenium-grid-hub") {
         setWebdriverSeleniumGridHub(value.toString());
     }
+    if (option == "fork-server") {
+        setForkServer(value.toString());
+    }
+    if (option == "fork-client") {
+        setForkClient(value.toString());
+    }
 }
 
 void Config::handleParam(const QString& param, const QVariant &value)
@@ -43,6 +43,16 @@ class Config: public QObject
     Q_OBJECT
     Q_PROPERTY(QString cookiesFile READ cookiesFile WRITE setCookiesFile)
     Q_PROPERTY(bool diskCacheEnabled READ diskCacheEnabled WRITE setDiskCacheEnabled)
+    Q_PROPERTY(bool dfgJitEnabled READ dfgJitEnabled WRITE setDfgJitEnabled)
+    Q_PROPERTY(int gcMarkingThreads READ gcMarkingThreads WRITE setGcMarkingThreads)
+    Q_PROPERTY(bool gcGenerational READ gcGenerational WRITE setGcGenerational)
+    Q_PROPERTY(int imageDecodingThreads READ imageDecodingThreads WRITE setImageDecodingThreads)
+    Q_PROPERTY(int maxDecodedImageArea READ maxDecodedImageArea WRITE setMaxDecodedImageArea)
+    Q_PROPERTY(int memoryCacheSize READ memoryCacheSize WRITE setMemoryCacheSize)
+    Q_PROPERTY(int memoryCacheDeadSize READ memoryCacheDeadSize WRITE setMemoryCacheDeadSize)
+    Q_PROPERTY(int maxPagesInCache READ maxPagesInCache WRITE setMaxPagesInCache)
+    Q_PROPERTY(int regExpCacheSize READ regExpCacheSize WRITE setRegExpCacheSize)
+    Q_PROPERTY(int regExpCacheMaxPatternLength READ regExpCacheMaxPatternLength WRITE setRegExpCacheMaxPatternLength)
     Q_PROPERTY(int maxDiskCacheSize READ maxDiskCacheSize WRITE setMaxDiskCacheSize)
     Q_PROPERTY(bool ignoreSslErrors READ ignoreSslErrors WRITE setIgnoreSslErrors)
     Q_PROPERTY(bool localToRemoteUrlAccessEnabled READ localToRemoteUrlAccessEnabled WRITE setLocalToRemoteUrlAccessEnabled)
@@ -53,6 +63,7 @@ class Config: public QObject
     Q_PROPERTY(QString scriptEncoding READ scriptEncoding WRITE setScriptEncoding)
     Q_PROPERTY(bool webSecurityEnabled READ webSecurityEnabled WRITE setWebSecurityEnabled)
     Q_PROPERTY(QString offlineStoragePath READ offlineStoragePath WRITE setOfflineStoragePath)
+    Q_PROPERTY(QString scriptCachePath READ scriptCachePath WRITE setScriptCachePath)
     Q_PROPERTY(int offlineStorageDefaultQuota READ offlineStorageDefaultQuota WRITE setOfflineStorageDefaultQuota)
     Q_PROPERTY(bool printDebugMessages READ printDebugMessages WRITE setPrintDebugMessages)
     Q_PROPERTY(bool javascriptCanOpenWindows READ javascriptCanOpenWindows WRITE setJavascriptCanOpenWindows)
@@ -63,6 +74,8 @@ class Config: public QObject
     Q_PROPERTY(QString webdriverLogFile READ webdriverLogFile WRITE setWebdriverLogFile)
     Q_PROPERTY(QString webdriverLogLevel READ webdriverLogLevel WRITE setWebdriverLogLevel)
     Q_PROPERTY(QString webdriverSeleniumGridHub READ webdriverSeleniumGridHub WRITE setWebdriverSeleniumGridHub)
+    Q_PROPERTY(QString forkServer READ forkServer WRITE setForkServer)
+    Q_PROPERTY(QString forkClient READ forkClient WRITE setForkClient)
 
 public:
     Config(QObject *parent = 0);
@@ -82,6 +95,9 @@ public:
     QString offlineStoragePath() const;
     void setOfflineStoragePath(const QString &value);
 
+    QString scriptCachePath() const;
+    void setScriptCachePath(const QString &value);
+
     int offlineStorageDefaultQuota() const;
     void setOfflineStorageDefaultQuota(int offlineStorageDefaultQuota);
 
@@ -91,6 +107,36 @@ public:
     int maxDiskCacheSize() const;
     void setMaxDiskCacheSize(int maxDiskCacheSize);
 
+    bool dfgJitEnabled() const;
+    void setDfgJitEnabled(const bool value);
+
+    int gcMarkingThreads() const;
+    void setGcMarkingThreads(int gcMarkingThreads);
+
+    bool gcGenerational() const;
+    void setGcGenerational(const bool value);
+
+    int imageDecodingThreads() const;
+    void setImageDecodingThreads(int imageDecodingThreads);
+
+    int maxDecodedImageArea() const;
+    void setMaxDecodedImageArea(int maxDecodedImageArea);
+
+    int memoryCacheSize() const;
+    void setMemoryCacheSize(int memoryCacheSize);
+
+    int memoryCacheDeadSize() const;
+    void setMemoryCacheDeadSize(int memoryCacheDeadSize);
+
+    int maxPagesInCache() const;
+    void setMaxPagesInCache(int maxPagesInCache);
+
+    int regExpCacheSize() const;
+    void setRegExpCacheSize(int regExpCacheSize);
+
+    int regExpCacheMaxPatternLength() const;
+    void setRegExpCacheMaxPatternLength(int regExpCacheMaxPatternLength);
+
     bool ignoreSslErrors() const;
     void setIgnoreSslErrors(const bool value);
 
@@ -173,6 +219,14 @@ public:
     void setWebdriverSeleniumGridHub(const QString& hubUrl);
     QString webdriverSeleniumGridHub() const;
 
+    void setForkServer(const QString& socketPath);
+    QString forkServer() const;
+    bool isForkServerMode() const;
+
+    void setForkClient(const QString& socketPath);
+    QString forkClient() const;
+    bool isForkClientMode() const;
+
 public slots:
     void handleSwitch(const QString &sw);
     void handleOption(const QString &option, const QVariant &value);
@@ -190,8 +244,19 @@ private:
     bool m_autoLoadImages;
     QString m_cookiesFile;
     QString m_offlineStoragePath;
+    QString m_scriptCachePath;
     int m_offlineStorageDefaultQuota;
     bool m_diskCacheEnabled;
+    bool m_dfgJitEnabled;
+    int m_gcMarkingThreads;
+    bool m_gcGenerational;
+    int m_imageDecodingThreads;
+    int m_maxDecodedImageArea;
+    int m_memoryCacheSize;
+    int m_memoryCacheDeadSize;
+    int m_maxPagesInCache;
+    int m_regExpCacheSize;
+    int m_regExpCacheMaxPatternLength;
     int m_maxDiskCacheSize;
     bool m_ignoreSslErrors;
     bool m_localToRemoteUrlAccessEnabled;
@@ -223,6 +288,8 @@ private:
     QString m_webdriverLogFile;
     QString m_webdriverLogLevel;
     QString m_webdriverSeleniumGridHub;
+    QString m_forkServer;
+    QString m_forkClient;
 };
 
 #endif // CONFIG_H
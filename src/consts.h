@@ -41,6 +41,8 @@
 #define HTTP_HEADER_CONTENT_TYPE        "content-type"
 
 #define COFFEE_SCRIPT_EXTENSION     ".coffee"
+#define COFFEE_SCRIPT_CACHE_DIR     "coffee-script"
+#define COFFEE_SCRIPT_CACHE_MAX_SIZE (5 * 1024 * 1024)
 
 #define JS_ELEMENT_CLICK "(function (el) { " \
         "var ev = document.createEvent('MouseEvents');" \
@@ -65,6 +67,10 @@
 #define PAGE_SETTINGS_WEB_SECURITY_ENABLED  "webSecurityEnabled"
 #define PAGE_SETTINGS_JS_CAN_OPEN_WINDOWS   "javascriptCanOpenWindows"
 #define PAGE_SETTINGS_JS_CAN_CLOSE_WINDOWS  "javascriptCanCloseWindows"
+#define PAGE_SETTINGS_MAX_REQUESTS_PER_HOST "maxRequestsPerHost"
+#define PAGE_SETTINGS_RESOURCE_PRIORITIES   "resourcePriorities"
+#define PAGE_SETTINGS_NETWORK_IDLE_TIME     "networkIdleTime"
+#define PAGE_SETTINGS_VISUALLY_COMPLETE_TIME "visuallyCompleteTime"
 
 #define DEFAULT_WEBDRIVER_CONFIG            "127.0.0.1:8910"
 
@@ -34,6 +34,17 @@
 #include <QDir>
 #include <QDebug>
 #include <QDateTime>
+#include <QPair>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QMetaObject>
+#include <QtConcurrentMap>
+
+#include <limits>
+
+// Binary files bigger than this are mapped in memory when read whole,
+// instead of being copied into an intermediate buffer first
+#define FILE_MAP_THRESHOLD (1024 * 1024)
 
 // File
 // public:
@@ -61,14 +72,7 @@ File::~File()
 // public slots:
 QString File::read(const QVariant &n)
 {
-    // Default to 1024 (used when n is "null")
-    qint64 bytesToRead = 1024;
-
-    // If parameter can be converted to a qint64, do so and use that value instead
-    if (n.canConvert(QVariant::LongLong)) {
-        bytesToRead = n.toLongLong();
-    }
-
+    const qint64 bytesToRead = _bytesToRead(n);
     const bool isReadAll = 0 > bytesToRead;
 
     if ( !m_file->isReadable() ) {
@@ -95,6 +99,20 @@ QString File::read(const QVariant &n)
         return ret;
     } else {
         // binary file
+        if (isReadAll && !_fitsInMemoryBuffer()) {
+            qDebug() << "File::read - " << "Too big to be read whole:" << m_file->fileName();
+            return QString();
+        }
+        if (isReadAll && _isMappable()) {
+            const qint64 size = m_file->size();
+            uchar *mapped = m_file->map(0, size);
+            if (mapped) {
+                QString ret = QString::fromLatin1(reinterpret_cast<const char *>(mapped), static_cast<int>(size));
+                m_file->unmap(mapped);
+                return ret;
+            }
+        }
+
         QByteArray data;
         if (isReadAll) {
             // This code, for some reason, reads the whole file from 0 to EOF,
@@ -106,12 +124,35 @@ QString File::read(const QVariant &n)
         } else {
             data = m_file->read(bytesToRead);
         }
-        QString ret(data.size());
-        for(int i = 0; i < data.size(); ++i) {
-            ret[i] = data.at(i);
-        }
-        return ret;
+        // Each byte becomes one character: the size is given explicitly, so "\0" is preserved
+        return QString::fromLatin1(data.constData(), data.size());
+    }
+}
+
+QByteArray File::readBytes(const QVariant &n)
+{
+    const qint64 bytesToRead = _bytesToRead(n);
+
+    if ( !m_file->isReadable() ) {
+        qDebug() << "File::readBytes - " << "Couldn't read:" << m_file->fileName();
+        return QByteArray();
+    }
+    if ( m_file->isWritable() ) {
+        // make sure we write everything to disk before reading
+        flush();
+    }
+    if ( m_fileStream ) {
+        // text file: read through the stream, so its buffer stays consistent
+        qDebug() << "File::readBytes - " << "Reading bytes from a text file:" << m_file->fileName();
+        const QString text = 0 > bytesToRead ? m_fileStream->readAll() : m_fileStream->read(bytesToRead);
+        return m_fileStream->codec()->fromUnicode(text);
+    }
+
+    if (0 > bytesToRead && !_fitsInMemoryBuffer()) {
+        qDebug() << "File::readBytes - " << "Too big to be read whole:" << m_file->fileName();
+        return QByteArray();
     }
+    return 0 > bytesToRead ? m_file->readAll() : m_file->read(bytesToRead);
 }
 
 bool File::write(const QString &data)
@@ -129,12 +170,26 @@ bool File::write(const QString &data)
         return true;
     } else {
         // binary file
-        QByteArray bytes(data.size(), Qt::Uninitialized);
-        for(int i = 0; i < data.size(); ++i) {
-            bytes[i] = data.at(i).toAscii();
+        return m_file->write(data.toLatin1());
+    }
+}
+
+bool File::writeBytes(const QByteArray &data)
+{
+    if ( !m_file->isWritable() ) {
+        qDebug() << "File::writeBytes - " << "Couldn't write:" << m_file->fileName();
+        return false;
+    }
+    if ( m_fileStream ) {
+        // text file: go through the stream, to preserve the order of writes
+        (*m_fileStream) << m_fileStream->codec()->toUnicode(data);
+        if (_isUnbuffered()) {
+            m_fileStream->flush();
         }
-        return m_file->write(bytes);
+        return true;
     }
+
+    return m_file->write(data) == data.size();
 }
 
 bool File::seek(const qint64 pos)
@@ -266,13 +321,265 @@ bool File::_isUnbuffered() const
     return m_file->openMode() & QIODevice::Unbuffered;
 }
 
+bool File::_isMappable() const
+{
+    // Only regular files can be mapped, and the mapping mustn't miss pending writes
+    return !m_file->isSequential()
+            && !m_file->isWritable()
+            && m_file->size() > FILE_MAP_THRESHOLD;
+}
+
+bool File::_fitsInMemoryBuffer() const
+{
+    // QString and QByteArray sizes are ints
+    return m_file->isSequential() || m_file->size() <= std::numeric_limits<int>::max();
+}
+
+qint64 File::_bytesToRead(const QVariant &n) const
+{
+    // Default to 1024 (used when n is "null")
+    qint64 bytesToRead = 1024;
+
+    // If parameter can be converted to a qint64, do so and use that value instead
+    if (n.canConvert(QVariant::LongLong)) {
+        bytesToRead = n.toLongLong();
+    }
+
+    return bytesToRead;
+}
+
+
+// FileSystemTask
+/**
+ * Runs one FileSystem operation on a thread of the pool,
+ * and reports the outcome back to the FileSystem (on its own thread).
+ *
+ * @class FileSystemTask
+ */
+class FileSystemTask : public QRunnable
+{
+public:
+    enum Operation {
+        CopyTree,
+        RemoveTree,
+        Copy,
+        Remove,
+        List,
+        Read,
+        Write
+    };
+
+    FileSystemTask(FileSystem *fs, const int id, const Operation operation, const QVariantList &args)
+        : m_fs(fs)
+        , m_id(id)
+        , m_operation(operation)
+        , m_args(args)
+    { }
+
+    void run() {
+        bool ok = false;
+        QVariant result;
+
+        switch (m_operation) {
+        case CopyTree:
+            ok = FileSystem::copyTreeParallel(m_args.at(0).toString(), m_args.at(1).toString());
+            break;
+        case RemoveTree:
+            ok = FileSystem::removeTreeParallel(m_args.at(0).toString());
+            break;
+        case Copy:
+            ok = QFile(m_args.at(0).toString()).copy(m_args.at(1).toString());
+            break;
+        case Remove:
+            ok = QFile::remove(m_args.at(0).toString());
+            break;
+        case List: {
+            QDir dir(m_args.at(0).toString());
+            ok = dir.exists();
+            result = dir.entryList();
+            break;
+        }
+        case Read: {
+            QString content;
+            ok = FileSystem::readFile(m_args.at(0).toString(), m_args.at(1).toMap(), &content);
+            result = content;
+            break;
+        }
+        case Write:
+            ok = FileSystem::writeFile(m_args.at(0).toString(), m_args.at(1).toString(), m_args.at(2).toMap());
+            break;
+        }
+
+        QMetaObject::invokeMethod(m_fs, "_onAsyncTaskDone", Qt::QueuedConnection,
+                                  Q_ARG(int, m_id), Q_ARG(bool, ok), Q_ARG(QVariant, result));
+    }
+
+private:
+    FileSystem *m_fs;
+    int m_id;
+    Operation m_operation;
+    QVariantList m_args;
+};
+
+// Entry of a parallel directory walk: a file to copy or to remove
+struct TreeEntry {
+    QString source;
+    QString destination;
+    bool ok;
+};
+
+static void copyTreeEntry(TreeEntry &entry)
+{
+    entry.ok = QFile(entry.source).copy(entry.destination);
+}
+
+static void removeTreeEntry(TreeEntry &entry)
+{
+    entry.ok = QFile::remove(entry.source);
+}
+
+static bool allTreeEntriesOk(const QList<TreeEntry> &entries)
+{
+    foreach (const TreeEntry &entry, entries) {
+        if (!entry.ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
 
 // FileSystem
 // public:
 FileSystem::FileSystem(QObject *parent)
     : QObject(parent)
+    , m_nextAsyncTaskId(0)
 { }
 
+bool FileSystem::copyTreeParallel(const QString &source, const QString &destination)
+{
+    QDir::Filters sourceDirFilter = QDir::NoDotAndDotDot | QDir::AllDirs | QDir::Files | QDir::NoSymLinks | QDir::Drives;
+    QList<TreeEntry> files;
+    QList<QPair<QString, QString> > dirs;
+
+    if (!QDir(source).exists()) {
+        return true;
+    }
+
+    // Walk the tree creating the directories, and collect the files to copy
+    dirs.append(qMakePair(source, destination));
+    while (!dirs.isEmpty()) {
+        const QPair<QString, QString> dir = dirs.takeFirst();
+
+        if (!QFile::exists(dir.second) && !QDir().mkdir(dir.second)) {
+            return false;
+        }
+
+        foreach(QFileInfo entry, QDir(dir.first).entryInfoList(sourceDirFilter, QDir::DirsFirst)) {
+            const QString entryDestination = dir.second + "/" + entry.fileName();
+            if (entry.isDir()) {
+                dirs.append(qMakePair(entry.absoluteFilePath(), entryDestination));
+            } else {
+                TreeEntry file = { entry.absoluteFilePath(), entryDestination, false };
+                files.append(file);
+            }
+        }
+    }
+
+    // Copy the files in parallel
+    QtConcurrent::blockingMap(files, copyTreeEntry);
+    return allTreeEntriesOk(files);
+}
+
+bool FileSystem::removeTreeParallel(const QString &path)
+{
+    QDir::Filters dirFilter = QDir::NoDotAndDotDot | QDir::System | QDir::Hidden | QDir::AllDirs | QDir::Files;
+    QList<TreeEntry> files;
+    QStringList dirs;
+
+    if (!QDir(path).exists()) {
+        return true;
+    }
+
+    // Walk the tree collecting files and directories (parents before children)
+    dirs.append(path);
+    for (int i = 0; i < dirs.size(); ++i) {
+        foreach(QFileInfo info, QDir(dirs.at(i)).entryInfoList(dirFilter, QDir::DirsFirst)) {
+            if (info.isDir() && !info.isSymLink()) {
+                dirs.append(info.absoluteFilePath());
+            } else {
+                TreeEntry file = { info.absoluteFilePath(), QString(), false };
+                files.append(file);
+            }
+        }
+    }
+
+    // Remove the files in parallel
+    QtConcurrent::blockingMap(files, removeTreeEntry);
+    if (!allTreeEntriesOk(files)) {
+        return false;
+    }
+
+    // Then the (now empty) directories, children before parents
+    for (int i = dirs.size() - 1; i >= 0; --i) {
+        if (!QDir().rmdir(dirs.at(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FileSystem::readFile(const QString &path, const QVariantMap &opts, QString *content)
+{
+    const bool isBinary = opts.value("mode").toString().contains('b', Qt::CaseInsensitive);
+
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly)) {
+        return false;
+    }
+    const QByteArray data = file.readAll();
+
+    if (isBinary) {
+        *content = QString::fromLatin1(data.constData(), data.size());
+    } else {
+        QTextCodec *codec = QTextCodec::codecForName(opts.value("charset", "UTF-8").toString().toAscii());
+        if (!codec) {
+            return false;
+        }
+        *content = codec->toUnicode(data);
+    }
+    return true;
+}
+
+bool FileSystem::writeFile(const QString &path, const QString &content, const QVariantMap &opts)
+{
+    const QString mode = opts.value("mode").toString();
+    const bool isBinary = mode.contains('b', Qt::CaseInsensitive);
+    const bool isAppend = mode.contains('a', Qt::CaseInsensitive) || mode.contains('+');
+
+    QByteArray data;
+    if (isBinary) {
+        data = content.toLatin1();
+    } else {
+        QTextCodec *codec = QTextCodec::codecForName(opts.value("charset", "UTF-8").toString().toAscii());
+        if (!codec) {
+            return false;
+        }
+        data = codec->fromUnicode(content);
+    }
+
+    // Make sure the full path exists
+    if (!QDir().mkpath(QFileInfo(path).dir().absolutePath())) {
+        return false;
+    }
+
+    QFile file(path);
+    if (!file.open(isAppend ? QFile::WriteOnly | QFile::Append : QFile::WriteOnly)) {
+        return false;
+    }
+    return file.write(data) == data.size();
+}
+
 // public slots:
 
 // Attributes
@@ -528,3 +835,58 @@ bool FileSystem::_remove(const QString &path) const
 bool FileSystem::_copy(const QString &source, const QString &destination) const {
     return QFile(source).copy(destination);
 }
+
+// Asynchronous operations
+int FileSystem::_copyTreeAsync(const QString &source, const QString &destination)
+{
+    return _startAsyncTask(FileSystemTask::CopyTree, QVariantList() << source << destination);
+}
+
+int FileSystem::_removeTreeAsync(const QString &path)
+{
+    return _startAsyncTask(FileSystemTask::RemoveTree, QVariantList() << path);
+}
+
+int FileSystem::_copyAsync(const QString &source, const QString &destination)
+{
+    return _startAsyncTask(FileSystemTask::Copy, QVariantList() << source << destination);
+}
+
+int FileSystem::_removeAsync(const QString &path)
+{
+    return _startAsyncTask(FileSystemTask::Remove, QVariantList() << path);
+}
+
+int FileSystem::_listAsync(const QString &path)
+{
+    return _startAsyncTask(FileSystemTask::List, QVariantList() << path);
+}
+
+int FileSystem::_readAsync(const QString &path, const QVariantMap &opts)
+{
+    return _startAsyncTask(FileSystemTask::Read, QVariantList() << path << opts);
+}
+
+int FileSystem::_writeAsync(const QString &path, const QString &content, const QVariantMap &opts)
+{
+    return _startAsyncTask(FileSystemTask::Write, QVariantList() << path << content << opts);
+}
+
+// private slots:
+void FileSystem::_onAsyncTaskDone(const int id, const bool ok, const QVariant &result)
+{
+    qDebug() << "FileSystem - _onAsyncTaskDone:" << id << ok;
+    emit _asyncFinished(id, ok, result);
+}
+
+// private:
+int FileSystem::_startAsyncTask(const int operation, const QVariantList &args)
+{
+    const int id = m_nextAsyncTaskId++;
+
+    qDebug() << "FileSystem - _startAsyncTask:" << id << operation << args;
+    QThreadPool::globalInstance()->start(
+                new FileSystemTask(this, id, static_cast<FileSystemTask::Operation>(operation), args));
+
+    return id;
+}
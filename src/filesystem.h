@@ -54,6 +54,19 @@ public slots:
      */
     QString read(const QVariant &n = -1);
     bool write(const QString &data);
+    /**
+     * Binary counterpart of {@link read()}: bytes are returned untouched, as a byte array.
+     * Unlike {@link read()}, reading up to EOF starts from the current position,
+     * so the file can be streamed in chunks.
+     *
+     * @param n Number of bytes to read (a negative value means read up to EOF)
+     */
+    QByteArray readBytes(const QVariant &n = -1);
+    /**
+     * Binary counterpart of {@link write()}.
+     * Accepts byte arrays, typed arrays and (Latin-1) strings.
+     */
+    bool writeBytes(const QByteArray &data);
 
     bool seek(const qint64 pos);
 
@@ -69,6 +82,9 @@ public slots:
 
 private:
     bool _isUnbuffered() const;
+    bool _isMappable() const;
+    bool _fitsInMemoryBuffer() const;
+    qint64 _bytesToRead(const QVariant &n) const;
 
     QFile *m_file;
     QTextStream *m_fileStream;
@@ -84,6 +100,13 @@ class FileSystem : public QObject
 public:
     FileSystem(QObject *parent = 0);
 
+    // Thread-safe implementations of the asynchronous operations
+    // (parallel directory walks for the "Tree" operations)
+    static bool copyTreeParallel(const QString &source, const QString &destination);
+    static bool removeTreeParallel(const QString &path);
+    static bool readFile(const QString &path, const QVariantMap &opts, QString *content);
+    static bool writeFile(const QString &path, const QString &content, const QVariantMap &opts);
+
 public slots:
     // Attributes
     // 'size(path)' implemented in "filesystem-shim.js" using '_size(path)'
@@ -139,6 +162,29 @@ public slots:
     bool isReadable(const QString &path) const;
     bool isWritable(const QString &path) const;
     bool isLink(const QString &path) const;
+
+    // Asynchronous operations
+    // They run on a thread pool and return a request id right away:
+    // the outcome is notified on the main thread via "_asyncFinished(id, ok, result)".
+    // 'xxxAsync(..., callback)' implemented in "fs.js" using '_xxxAsync(...)'
+    int _copyTreeAsync(const QString &source, const QString &destination);
+    int _removeTreeAsync(const QString &path);
+    int _copyAsync(const QString &source, const QString &destination);
+    int _removeAsync(const QString &path);
+    int _listAsync(const QString &path);
+    int _readAsync(const QString &path, const QVariantMap &opts);
+    int _writeAsync(const QString &path, const QString &content, const QVariantMap &opts);
+
+signals:
+    void _asyncFinished(const int id, const bool ok, const QVariant &result);
+
+private slots:
+    void _onAsyncTaskDone(const int id, const bool ok, const QVariant &result);
+
+private:
+    int _startAsyncTask(const int operation, const QVariantList &args);
+
+    int m_nextAsyncTaskId;
 };
 
 #endif // FILESYSTEM_H
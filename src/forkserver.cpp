@@ -0,0 +1,327 @@
+/*
+  This file is part of the PhantomJS project from Ofi Labs.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the <organization> nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "forkserver.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QSocketNotifier>
+
+#ifdef Q_OS_UNIX
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "phantom.h"
+
+static ForkServer *forkServerInstance = NULL;
+
+#ifdef Q_OS_UNIX
+// Self-pipe used to turn SIGCHLD into an event the main loop can handle
+static int sigchldPipe[2] = { -1, -1 };
+
+static void sigchldHandler(int)
+{
+    int savedErrno = errno;
+    char c = 0;
+    if (::write(sigchldPipe[1], &c, 1) < 0) {
+        // Nothing to do: the pipe is already full of wake ups
+    }
+    errno = savedErrno;
+}
+#endif
+
+// public:
+ForkServer *ForkServer::instance()
+{
+    if (NULL == forkServerInstance) {
+        forkServerInstance = new ForkServer(QCoreApplication::instance());
+    }
+    return forkServerInstance;
+}
+
+bool ForkServer::listen(const QString &socketPath)
+{
+#ifdef Q_OS_UNIX
+    if (sigchldPipe[0] == -1) {
+        if (::pipe(sigchldPipe) != 0) {
+            qDebug() << "ForkServer - listen: Unable to create the SIGCHLD pipe";
+            return false;
+        }
+        ::fcntl(sigchldPipe[0], F_SETFL, O_NONBLOCK);
+        ::fcntl(sigchldPipe[1], F_SETFL, O_NONBLOCK);
+        ::fcntl(sigchldPipe[0], F_SETFD, FD_CLOEXEC);
+        ::fcntl(sigchldPipe[1], F_SETFD, FD_CLOEXEC);
+
+        struct sigaction action;
+        ::memset(&action, 0, sizeof(action));
+        action.sa_handler = sigchldHandler;
+        action.sa_flags = SA_RESTART | SA_NOCLDSTOP;
+        ::sigemptyset(&action.sa_mask);
+        ::sigaction(SIGCHLD, &action, 0);
+
+        m_sigchldNotifier = new QSocketNotifier(sigchldPipe[0], QSocketNotifier::Read, this);
+        connect(m_sigchldNotifier, SIGNAL(activated(int)), SLOT(handleWorkerExited()));
+    }
+
+    // Remove a stale socket left behind by a previous server
+    QLocalServer::removeServer(socketPath);
+    // Anyone who can connect runs scripts as this user: keep the socket to ourselves
+    mode_t oldMask = ::umask(S_IRWXG | S_IRWXO);
+    bool listening = m_server->listen(socketPath);
+    ::umask(oldMask);
+    if (!listening) {
+        qDebug() << "ForkServer - listen: Unable to listen on" << socketPath << ":" << m_server->errorString();
+        return false;
+    }
+
+    qDebug() << "ForkServer - listen: Waiting for requests on" << m_server->fullServerName();
+    return true;
+#else
+    Q_UNUSED(socketPath);
+    qDebug() << "ForkServer - listen: Not supported on this platform";
+    return false;
+#endif
+}
+
+int ForkServer::request(const QString &socketPath, const QString &workingDirectory,
+                        const QString &scriptFile, const QStringList &scriptArgs)
+{
+    QLocalSocket socket;
+    socket.connectToServer(socketPath);
+    if (!socket.waitForConnected()) {
+        qDebug() << "ForkServer - request: Unable to connect to" << socketPath << ":" << socket.errorString();
+        return -1;
+    }
+
+    QStringList request;
+    request << workingDirectory << scriptFile << scriptArgs;
+    socket.write((request.join("\n") + "\n\n").toUtf8());
+
+    // Relay the output as it comes, but for what may turn out to be the exit code line
+    QByteArray pending;
+    forever {
+        if (!socket.bytesAvailable() && !socket.waitForReadyRead(-1)) {
+            break;
+        }
+        pending += socket.readAll();
+        int lastLine = pending.lastIndexOf('\n', pending.size() - 2);
+        if (lastLine > 0) {
+            ::fwrite(pending.constData(), 1, lastLine, stdout);
+            ::fflush(stdout);
+            pending.remove(0, lastLine);
+        }
+    }
+    pending += socket.readAll();
+
+    // The server separates the exit code from the output with a line break of its own
+    int lastLine = pending.lastIndexOf('\n', pending.size() - 2);
+    bool ok = false;
+    int exitCode = lastLine >= 0 ? pending.mid(lastLine + 1).trimmed().toInt(&ok) : 0;
+    if (!ok) {
+        qDebug() << "ForkServer - request: The server closed the connection without an exit code";
+        ::fwrite(pending.constData(), 1, pending.size(), stdout);
+        ::fflush(stdout);
+        return -1;
+    }
+    ::fwrite(pending.constData(), 1, lastLine, stdout);
+    ::fflush(stdout);
+    return exitCode;
+}
+
+// private slots:
+void ForkServer::handleNewConnection()
+{
+    while (m_server->hasPendingConnections()) {
+        QLocalSocket *socket = m_server->nextPendingConnection();
+        m_pendingRequests.insert(socket, QStringList());
+        connect(socket, SIGNAL(readyRead()), SLOT(handleRequestData()));
+        connect(socket, SIGNAL(disconnected()), SLOT(handleDisconnected()));
+        connect(socket, SIGNAL(disconnected()), socket, SLOT(deleteLater()));
+    }
+}
+
+void ForkServer::handleRequestData()
+{
+    QLocalSocket *socket = qobject_cast<QLocalSocket *>(sender());
+    if (!socket || !m_pendingRequests.contains(socket)) {
+        return;
+    }
+
+    QStringList &request = m_pendingRequests[socket];
+    while (socket->canReadLine()) {
+        QString line = QString::fromUtf8(socket->readLine());
+        line.chop(1);   //< Strip the trailing '\n'
+        if (!line.isEmpty()) {
+            request.append(line);
+            continue;
+        }
+
+        // An empty line terminates the request: it needs at least the working directory and the script
+        QStringList completeRequest = m_pendingRequests.take(socket);
+        disconnect(socket, SIGNAL(readyRead()), this, SLOT(handleRequestData()));
+        if (completeRequest.size() < 2) {
+            socket->write("Invalid request: expected the working directory and the script path\n-1\n");
+            socket->disconnectFromServer();
+        } else {
+            forkWorker(socket, completeRequest);
+        }
+        return;
+    }
+}
+
+void ForkServer::handleDisconnected()
+{
+    // A request left incomplete is dropped with its socket
+    m_pendingRequests.remove(qobject_cast<QLocalSocket *>(sender()));
+}
+
+void ForkServer::handleWorkerExited()
+{
+#ifdef Q_OS_UNIX
+    char buffer[64];
+    while (::read(sigchldPipe[0], buffer, sizeof(buffer)) > 0) {
+        // Drain the wake ups: every exited worker is reaped below
+    }
+
+    int status;
+    pid_t pid;
+    while ((pid = ::waitpid(-1, &status, WNOHANG)) > 0) {
+        if (!m_workers.contains(pid)) {
+            continue;
+        }
+        QPointer<QLocalSocket> socket = m_workers.take(pid);
+
+        int exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+        qDebug() << "ForkServer - handleWorkerExited: Worker" << pid << "exited with" << exitCode;
+
+        if (!socket || socket->state() != QLocalSocket::ConnectedState) {
+            // The client is gone: nobody to report the exit code to
+            continue;
+        }
+        socket->write(QString("\n%1\n").arg(exitCode).toUtf8());
+        socket->disconnectFromServer();
+    }
+#endif
+}
+
+void ForkServer::exitWorker(int code)
+{
+#ifdef Q_OS_UNIX
+    // Tearing the worker down would destroy the server it inherited, which unlinks
+    // the socket the parent is still listening on
+    ::fflush(NULL);
+    ::_exit(code);
+#else
+    Q_UNUSED(code);
+#endif
+}
+
+// private:
+ForkServer::ForkServer(QObject *parent)
+    : QObject(parent)
+    , m_server(new QLocalServer(this))
+    , m_sigchldNotifier(0)
+{
+    connect(m_server, SIGNAL(newConnection()), SLOT(handleNewConnection()));
+}
+
+void ForkServer::forkWorker(QLocalSocket *socket, const QStringList &request)
+{
+#ifdef Q_OS_UNIX
+    // Anything still buffered would otherwise be written by both processes
+    ::fflush(NULL);
+
+    pid_t pid = ::fork();
+    if (pid < 0) {
+        qDebug() << "ForkServer - forkWorker: Unable to fork a worker";
+        socket->write("Unable to fork a worker\n-1\n");
+        socket->disconnectFromServer();
+        return;
+    }
+
+    if (pid > 0) {
+        // Parent: the worker writes to the socket directly, report its exit code once reaped
+        m_workers.insert(pid, socket);
+        return;
+    }
+
+    setupWorker(socket, request);
+#else
+    Q_UNUSED(request);
+    socket->disconnectFromServer();
+#endif
+}
+
+void ForkServer::setupWorker(QLocalSocket *socket, const QStringList &request)
+{
+#ifdef Q_OS_UNIX
+    // The worker only serves its own request
+    ::signal(SIGCHLD, SIG_DFL);
+    m_sigchldNotifier->setEnabled(false);
+    ::close(sigchldPipe[0]);
+    ::close(sigchldPipe[1]);
+    // NOTE: QLocalServer::close(), or its destructor, would also unlink the socket the
+    // parent is still listening on: the server is left alone, and never destroyed
+    m_server->setParent(0);
+    foreach (QObject *child, m_server->children()) {
+        if (QSocketNotifier *notifier = qobject_cast<QSocketNotifier *>(child)) {
+            notifier->setEnabled(false);
+            ::close(notifier->socket());
+        } else if (QLocalSocket *other = qobject_cast<QLocalSocket *>(child)) {
+            if (other != socket) {
+                other->abort();
+            }
+        }
+    }
+
+    // Everything the script prints goes straight to the client
+    int fd = socket->socketDescriptor();
+    ::dup2(fd, STDOUT_FILENO);
+    ::dup2(fd, STDERR_FILENO);
+
+    QDir::setCurrent(request.at(0));
+    connect(Phantom::instance(), SIGNAL(aboutToExit(int)), SLOT(exitWorker(int)));
+    if (!Phantom::instance()->executeForked(request.at(1), request.mid(2))) {
+        ::fflush(NULL);
+        ::_exit(Phantom::instance()->returnValue());
+    }
+#else
+    Q_UNUSED(socket);
+    Q_UNUSED(request);
+#endif
+}
@@ -0,0 +1,92 @@
+/*
+  This file is part of the PhantomJS project from Ofi Labs.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the <organization> nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef FORKSERVER_H
+#define FORKSERVER_H
+
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QStringList>
+
+class QLocalServer;
+class QLocalSocket;
+class QSocketNotifier;
+
+/**
+ * Fork Server ("--fork-server=<socket path>").
+ *
+ * Keeps a fully initialized PhantomJS (QApplication, WebKit, configuration,
+ * bootstrap) waiting on a local socket, and forks a worker for every request,
+ * so that each job only pays for a fork plus the evaluation of its script.
+ *
+ * Protocol, one request per connection:
+ * <pre>
+ *   client -> server: working directory, script path and script arguments,
+ *                     one per line (UTF-8), terminated by an empty line
+ *   server -> client: everything the script writes on stdout/stderr,
+ *                     then a last line with its exit code
+ * </pre>
+ * "--fork-client=<socket path>" makes PhantomJS itself such a client.
+ *
+ * NOTE: Only available on Unix. The warm process must not have started
+ * any thread of its own before forking, as only the forking thread survives.
+ */
+class ForkServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static ForkServer *instance();
+
+    bool listen(const QString &socketPath);
+
+    // Runs a script in a worker of the server listening on socketPath, relaying its
+    // output to stdout. Returns its exit code, or -1 if the request failed.
+    static int request(const QString &socketPath, const QString &workingDirectory,
+                       const QString &scriptFile, const QStringList &scriptArgs);
+
+private slots:
+    void handleNewConnection();
+    void handleRequestData();
+    void handleDisconnected();
+    void handleWorkerExited();
+    void exitWorker(int code);
+
+private:
+    ForkServer(QObject *parent = 0);
+    void forkWorker(QLocalSocket *socket, const QStringList &request);
+    void setupWorker(QLocalSocket *socket, const QStringList &request);
+
+    QLocalServer *m_server;
+    QSocketNotifier *m_sigchldNotifier;
+    QHash<QLocalSocket *, QStringList> m_pendingRequests;
+    // A client may go away before its worker exits
+    QHash<qint64, QPointer<QLocalSocket> > m_workers;
+};
+
+#endif // FORKSERVER_H
@@ -0,0 +1,179 @@
+/*
+  This file is part of the PhantomJS project from Ofi Labs.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the <organization> nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "metrics.h"
+
+#include <QCoreApplication>
+#include <QTimer>
+
+#include "DumpRenderTreeSupportQt.h"
+
+// How often the main event loop is checked for lag
+#define EVENT_LOOP_PROBE_INTERVAL   100
+
+static Metrics *metricsInstance = NULL;
+
+// public:
+Metrics *Metrics::instance()
+{
+    if (NULL == metricsInstance) {
+        metricsInstance = new Metrics(QCoreApplication::instance());
+    }
+    return metricsInstance;
+}
+
+void Metrics::recordPageLoad(const qint64 time, const bool ok)
+{
+    ++m_pageLoads;
+    if (!ok) {
+        ++m_pageLoadsFailed;
+    }
+    m_pageLoadTimeTotal += time;
+    m_pageLoadTimeMax = qMax(m_pageLoadTimeMax, time);
+    m_pageLoadTimeLast = time;
+}
+
+void Metrics::recordResourceRequested()
+{
+    ++m_resourcesRequested;
+}
+
+void Metrics::recordResourceReceived()
+{
+    ++m_resourcesReceived;
+}
+
+void Metrics::recordResourceBytes(const qint64 bytes)
+{
+    m_resourceBytes += bytes;
+}
+
+void Metrics::recordResourceError()
+{
+    ++m_resourcesFailed;
+}
+
+void Metrics::recordResourceTimeout()
+{
+    ++m_resourcesTimedOut;
+}
+
+void Metrics::recordRender(const qint64 time, const qint64 pixels)
+{
+    ++m_renders;
+    m_renderTimeTotal += time;
+    m_renderTimeMax = qMax(m_renderTimeMax, time);
+    m_renderPixels += pixels;
+}
+
+void Metrics::startEventLoopProbe()
+{
+    if (m_eventLoopProbe->isActive()) {
+        return;
+    }
+    m_eventLoopProbeElapsed.start();
+    m_eventLoopProbe->start();
+}
+
+QVariantMap Metrics::toMap() const
+{
+    QVariantMap pages;
+    pages["loads"] = m_pageLoads;
+    pages["failedLoads"] = m_pageLoadsFailed;
+    pages["totalLoadTime"] = m_pageLoadTimeTotal;
+    pages["maxLoadTime"] = m_pageLoadTimeMax;
+    pages["lastLoadTime"] = m_pageLoadTimeLast;
+
+    QVariantMap resources;
+    resources["requested"] = m_resourcesRequested;
+    resources["received"] = m_resourcesReceived;
+    resources["failed"] = m_resourcesFailed;
+    resources["timedOut"] = m_resourcesTimedOut;
+    resources["bytes"] = m_resourceBytes;
+
+    QVariantMap rendering;
+    rendering["renders"] = m_renders;
+    rendering["totalRenderTime"] = m_renderTimeTotal;
+    rendering["maxRenderTime"] = m_renderTimeMax;
+    rendering["pixels"] = m_renderPixels;
+
+    QVariantMap eventLoop;
+    eventLoop["lastLag"] = m_eventLoopLagLast;
+    eventLoop["maxLag"] = m_eventLoopLagMax;
+    eventLoop["averageLag"] = m_eventLoopSamples > 0 ? (double) m_eventLoopLagTotal / m_eventLoopSamples : 0.0;
+
+    QVariantMap metrics;
+    metrics["uptime"] = m_uptime.elapsed();
+    metrics["pages"] = pages;
+    metrics["resources"] = resources;
+    metrics["rendering"] = rendering;
+    metrics["jsHeap"] = DumpRenderTreeSupportQt::javaScriptHeapStatistics();
+    metrics["regExp"] = DumpRenderTreeSupportQt::javaScriptRegExpStatistics();
+    metrics["eventLoop"] = eventLoop;
+    return metrics;
+}
+
+// private slots:
+void Metrics::probeEventLoop()
+{
+    // The probe should fire every EVENT_LOOP_PROBE_INTERVAL: anything later was spent blocked
+    qint64 lag = qMax(Q_INT64_C(0), m_eventLoopProbeElapsed.restart() - EVENT_LOOP_PROBE_INTERVAL);
+
+    ++m_eventLoopSamples;
+    m_eventLoopLagTotal += lag;
+    m_eventLoopLagMax = qMax(m_eventLoopLagMax, lag);
+    m_eventLoopLagLast = lag;
+}
+
+// private:
+Metrics::Metrics(QObject *parent)
+    : QObject(parent)
+    , m_pageLoads(0)
+    , m_pageLoadsFailed(0)
+    , m_pageLoadTimeTotal(0)
+    , m_pageLoadTimeMax(0)
+    , m_pageLoadTimeLast(0)
+    , m_resourcesRequested(0)
+    , m_resourcesReceived(0)
+    , m_resourcesFailed(0)
+    , m_resourcesTimedOut(0)
+    , m_resourceBytes(0)
+    , m_renders(0)
+    , m_renderTimeTotal(0)
+    , m_renderTimeMax(0)
+    , m_renderPixels(0)
+    , m_eventLoopProbe(new QTimer(this))
+    , m_eventLoopSamples(0)
+    , m_eventLoopLagTotal(0)
+    , m_eventLoopLagMax(0)
+    , m_eventLoopLagLast(0)
+{
+    m_uptime.start();
+
+    m_eventLoopProbe->setInterval(EVENT_LOOP_PROBE_INTERVAL);
+    connect(m_eventLoopProbe, SIGNAL(timeout()), SLOT(probeEventLoop()));
+}
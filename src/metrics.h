@@ -0,0 +1,100 @@
+/*
+  This file is part of the PhantomJS project from Ofi Labs.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the <organization> nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QVariantMap>
+
+class QTimer;
+
+/**
+ * Process-wide performance counters, exposed as <code>phantom.metrics</code>.
+ *
+ * Pages, the network access managers and the renderer report into it;
+ * JavaScriptCore heap statistics and the lag of the main event loop are
+ * sampled by the Metrics themselves. Times are in milliseconds.
+ *
+ * The event loop is only probed once startEventLoopProbe() is called, so
+ * processes that never read the metrics don't wake up every 100 ms for it.
+ */
+class Metrics : public QObject
+{
+    Q_OBJECT
+
+public:
+    static Metrics *instance();
+
+    void recordPageLoad(const qint64 time, const bool ok);
+    void recordResourceRequested();
+    void recordResourceReceived();
+    void recordResourceBytes(const qint64 bytes);
+    void recordResourceError();
+    void recordResourceTimeout();
+    void recordRender(const qint64 time, const qint64 pixels);
+
+    // Starts sampling the event loop lag; does nothing if already started
+    void startEventLoopProbe();
+
+    QVariantMap toMap() const;
+
+private slots:
+    void probeEventLoop();
+
+private:
+    Metrics(QObject *parent = 0);
+
+    QElapsedTimer m_uptime;
+
+    int m_pageLoads;
+    int m_pageLoadsFailed;
+    qint64 m_pageLoadTimeTotal;
+    qint64 m_pageLoadTimeMax;
+    qint64 m_pageLoadTimeLast;
+
+    int m_resourcesRequested;
+    int m_resourcesReceived;
+    int m_resourcesFailed;
+    int m_resourcesTimedOut;
+    qint64 m_resourceBytes;
+
+    int m_renders;
+    qint64 m_renderTimeTotal;
+    qint64 m_renderTimeMax;
+    qint64 m_renderPixels;
+
+    QTimer *m_eventLoopProbe;
+    QElapsedTimer m_eventLoopProbeElapsed;
+    int m_eventLoopSamples;
+    qint64 m_eventLoopLagTotal;
+    qint64 m_eventLoopLagMax;
+    qint64 m_eventLoopLagLast;
+};
+
+#endif // METRICS_H
@@ -42,8 +42,13 @@ exports.spawn = function (cmd, args, opts) {
     opts = {}
   }
 
-  opts.encoding = opts.encoding || "utf8"
-  ctx._setEncoding(opts.encoding)
+  // With `encoding: "binary"`, "data" handlers receive byte arrays
+  if ("binary" === opts.encoding) {
+    ctx._setBinary(true)
+  } else {
+    opts.encoding = opts.encoding || "utf8"
+    ctx._setEncoding(opts.encoding)
+  }
 
   ctx._start(cmd, args)
 
@@ -99,9 +104,52 @@ exports.execFile = function (cmd, args, opts, cb) {
 
 /**
  * fork(modulePath, [args], [options])
+ *
+ * Runs `modulePath` in another PhantomJS, which gets its own pages and core.
+ * Use `child.send(message)` and `child.on("message", cb)` to talk to it, and
+ * `require("child_process").parent` from within the child.
  */
 exports.fork = function (modulePath, args, opts) {
-  throw new Error("NotYetImplemented")
+  var ctx = newContext()
+
+  if (null == args) {
+    args = []
+  }
+
+  if (null == opts) {
+    opts = {}
+  }
+
+  opts.encoding = opts.encoding || "utf8"
+  ctx._setEncoding(opts.encoding)
+
+  ctx.send = function (message) {
+    return ctx._send(JSON.stringify(message))
+  }
+
+  if (!ctx._fork(modulePath, args)) {
+    throw new Error("Unable to fork '" + modulePath + "'")
+  }
+
+  return ctx
+}
+
+/**
+ * In a PhantomJS started by `fork()`, the channel to the parent:
+ * `parent.send(message)` and `parent.on("message", cb)`.
+ * `null` otherwise.
+ */
+exports.parent = !exports._forked ? null : {
+  send: function (message) {
+    return exports._sendToParent(JSON.stringify(message))
+  },
+  on: function (evt, cb) {
+    if ("message" === evt && isFunction(cb)) {
+      exports._parentMessage.connect(function (message) {
+        cb(JSON.parse(message))
+      })
+    }
+  }
 }
 
 
@@ -119,6 +167,16 @@ function newContext() {
       case "exit":
         handler = ctx[evt]
         break
+      case "message":
+        // Messages travel as JSON
+        handler = ctx[evt]
+        if (isFunction(cb)) {
+          var callback = cb
+          cb = function (message) {
+            callback(JSON.parse(message))
+          }
+        }
+        break
       default:
         break
     }
@@ -129,6 +187,7 @@ function newContext() {
     }
   }
 
+  ctx.stdin = new FakeWritableStream()
   ctx.stdout = new FakeReadableStream("stdout")
   ctx.stderr = new FakeReadableStream("stderr")
 
@@ -138,6 +197,35 @@ function newContext() {
       switch (evt) {
         case 'data':
           ctx[streamName + "Data"].connect(cb)
+          ctx[streamName + "Bytes"].connect(cb)
+          break
+        default:
+          break
+      }
+    }
+    this.pause = function () {
+      ctx._pauseOutput(streamName)
+    }
+    this.resume = function () {
+      ctx._resumeOutput(streamName)
+    }
+  }
+
+  // Emulates `Writable Stream`: `write()` returns false when the caller should wait for "drain"
+  function FakeWritableStream() {
+    this.write = function (chunk, encoding) {
+      return ctx._writeStdin(chunk, encoding || "")
+    }
+    this.end = function (chunk, encoding) {
+      if (null != chunk) {
+        ctx._writeStdin(chunk, encoding || "")
+      }
+      ctx._endStdin()
+    }
+    this.on = function (evt, cb) {
+      switch (evt) {
+        case 'drain':
+          ctx.stdinDrain.connect(cb)
           break
         default:
           break
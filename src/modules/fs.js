@@ -138,6 +138,46 @@ exports.write = function (path, content, modeOrOpts) {
     f.close();
 };
 
+/** Open, read and return the binary content of a file, as a byte array.
+ * It will throw an exception if it fails.
+ *
+ * NOTE: to stream big files, open them in 'rb' mode and call
+ * "file.readBytes(chunkSize)" until "file.atEnd()".
+ *
+ * @param path Path of the file to read from
+ * @return file content (byte array)
+ */
+exports.readBytes = function (path) {
+    var f = exports.open(path, 'rb'),
+        content = f.readBytes();
+
+    f.close();
+    return content;
+};
+
+/** Open and write binary content to a file.
+ * It will throw an exception if it fails.
+ *
+ * @param path Path of the file to write to
+ * @param content Content to write: a byte array, a typed array or a (Latin-1) string
+ * @param mode Open Mode. A string made of 'w', 'a/+' characters (default: 'w')
+ */
+exports.writeBytes = function (path, content, mode) {
+    if (typeof mode !== 'string') {
+        mode = 'w';
+    }
+    if (mode.indexOf('b') == -1) {
+        mode += 'b';
+    }
+    var f = exports.open(path, mode);
+
+    if (!f.writeBytes(content)) {
+        f.close();
+        throw "Unable to write to file '" + path + "'";
+    }
+    f.close();
+};
+
 /** Return the size of a file, in bytes.
  * It will throw an exception if it fails.
  *
@@ -224,6 +264,114 @@ exports.touch = function (path) {
     exports.write(path, "", 'a');
 };
 
+// Asynchronous operations
+// They run on a thread pool: "callback(error, result)" is invoked on the main thread
+// once the operation is completed. "error" is null in case of success.
+
+var asyncCallbacks = {};
+
+exports._asyncFinished.connect(function (id, ok, result) {
+    var pending = asyncCallbacks[id];
+    delete asyncCallbacks[id];
+
+    if (pending && typeof pending.callback === 'function') {
+        pending.callback(ok ? null : new Error(pending.errorMessage), ok ? result : undefined);
+    }
+});
+
+function startAsync(id, errorMessage, callback) {
+    asyncCallbacks[id] = {
+        callback: callback,
+        errorMessage: errorMessage
+    };
+}
+
+/** Read the content of a file, asynchronously.
+ *
+ * @param path Path of the file to read from
+ * @param modeOrOpts (optional) see "fs.read()"
+ * @param callback function(error, content)
+ */
+exports.readAsync = function (path, modeOrOpts, callback) {
+    if (typeof modeOrOpts === 'function') {
+        callback = modeOrOpts;
+        modeOrOpts = null;
+    }
+    if (typeof modeOrOpts == 'string') {
+        modeOrOpts = modeOrOpts.toLowerCase() == 'b' ? {mode: modeOrOpts} : {charset: modeOrOpts};
+    }
+    startAsync(exports._readAsync(path, modeOrOptsToOpts(modeOrOpts)),
+        "Unable to read file '" + path + "'", callback);
+};
+
+/** Write content to a file, asynchronously.
+ *
+ * @param path Path of the file to write to
+ * @param content Content to write to the file
+ * @param modeOrOpts (optional) see "fs.write()"
+ * @param callback function(error)
+ */
+exports.writeAsync = function (path, content, modeOrOpts, callback) {
+    if (typeof modeOrOpts === 'function') {
+        callback = modeOrOpts;
+        modeOrOpts = null;
+    }
+    startAsync(exports._writeAsync(path, content, modeOrOptsToOpts(modeOrOpts)),
+        "Unable to write file '" + path + "'", callback);
+};
+
+/** Copy a file, asynchronously.
+ *
+ * @param source Path of the source file
+ * @param destination Path of the destination file
+ * @param callback function(error)
+ */
+exports.copyAsync = function (source, destination, callback) {
+    startAsync(exports._copyAsync(source, destination),
+        "Unable to copy file '" + source + "' at '" + destination + "'", callback);
+};
+
+/** Copy a directory tree, asynchronously. Files are copied in parallel.
+ *
+ * @param source Path of the source directory tree
+ * @param destination Path of the destination directory tree
+ * @param callback function(error)
+ */
+exports.copyTreeAsync = function (source, destination, callback) {
+    startAsync(exports._copyTreeAsync(source, destination),
+        "Unable to copy directory tree '" + source + "' at '" + destination + "'", callback);
+};
+
+/** Remove a file, asynchronously.
+ *
+ * @param path Path of the file to remove
+ * @param callback function(error)
+ */
+exports.removeAsync = function (path, callback) {
+    startAsync(exports._removeAsync(path),
+        "Unable to remove file '" + path + "'", callback);
+};
+
+/** Remove a directory tree, asynchronously. Files are removed in parallel.
+ *
+ * @param path Path of the directory tree to remove
+ * @param callback function(error)
+ */
+exports.removeTreeAsync = function (path, callback) {
+    startAsync(exports._removeTreeAsync(path),
+        "Unable to remove directory tree '" + path + "'", callback);
+};
+
+/** List the content of a directory, asynchronously.
+ *
+ * @param path Path of the directory to list
+ * @param callback function(error, entries)
+ */
+exports.listAsync = function (path, callback) {
+    startAsync(exports._listAsync(path),
+        "Unable to list directory '" + path + "'", callback);
+};
+
 // Path stuff
 
 exports.join = function() {
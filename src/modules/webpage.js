@@ -262,6 +262,10 @@ function decorateNewPage(opts, page) {
 
     definePageSignalHandler(page, handlers, "onClosing", "closing");
 
+    definePageSignalHandler(page, handlers, "onNetworkIdle", "networkIdle");
+
+    definePageSignalHandler(page, handlers, "onVisuallyComplete", "visuallyComplete");
+
     // Private callback for "page.open()"
     definePageSignalHandler(page, handlers, "_onPageOpenFinished", "loadFinished");
 
@@ -381,6 +385,53 @@ function decorateNewPage(opts, page) {
         return this.evaluateJavaScript(str);
     };
 
+    /**
+     * compile a function to be evaluated in the page many times
+     * NOTE: the function is compiled once per frame and reused afterwards;
+     *       arguments are passed as they are, not serialized into source.
+     *       Page scripts share the frame's global object: they can reach the
+     *       compiled function and see its arguments.
+     * @param   {function}  func    the function to compile
+     * @return  {function}          invokes "func" in the page with the given arguments
+     *                              and returns the call result
+     */
+    page.compile = function (func) {
+        var thisPage = this, id, compiled;
+        if (!(func instanceof Function || typeof func === 'string' || func instanceof String)) {
+            throw "Wrong use of WebPage#compile";
+        }
+        id = this._compileFunction(func.toString());
+
+        compiled = function () {
+            return thisPage._callCompiledFunction(id, Array.prototype.slice.call(arguments));
+        };
+        compiled.release = function () {
+            thisPage._releaseCompiledFunction(id);
+        };
+        return compiled;
+    };
+
+    /**
+     * bring the page back to the state of a newly created one, so it can be reused
+     * NOTE: content, history, JS globals, handlers, settings and child pages are dropped;
+     *       the heavyweight objects behind the page are kept alive.
+     */
+    page.reset = function () {
+        var handlerName;
+        for (handlerName in handlers) {
+            if (handlers.hasOwnProperty(handlerName)) {
+                this[handlerName] = null;
+            }
+        }
+        this.onError = phantom.defaultErrorHandler;
+        this.onPageCreated = undefined;
+
+        // deep copy
+        this.settings = JSON.parse(JSON.stringify(phantom.defaultPageSettings));
+
+        this._reset();
+    };
+
     /**
      * evaluate a function in the page, asynchronously
      * NOTE: it won't return anything: the execution is asynchronous respect to the call.
@@ -449,6 +500,32 @@ function decorateNewPage(opts, page) {
         this._uploadFile(selector, fileNames);
     };
 
+    /**
+     * start sampling the JavaScript run by the page; a navigation ends the profile
+     * @param {number} intervalMs sampling interval in milliseconds (default 1)
+     * @return {boolean} whether the profiler was started
+     */
+    page.startProfiling = function(intervalMs) {
+        if (typeof intervalMs !== "number" || intervalMs <= 0) {
+            intervalMs = 1;
+        }
+
+        return this._startProfiling(Math.round(intervalMs * 1000));
+    };
+
+    /**
+     * stop sampling and return the profile, in Chrome's .cpuprofile format
+     * @param {string} path optional file to write the profile to
+     * @return {object} the profile, empty if the profiler was not running
+     */
+    page.stopProfiling = function(path) {
+        var profile = this._stopProfiling();
+        if (path && profile.nodes) {
+            require('fs').write(path, JSON.stringify(profile), 'w');
+        }
+        return profile;
+    };
+
     // Copy options into page
     if (opts) {
         page = copyInto(page, opts);
@@ -904,3 +981,40 @@ function decorateNewPage(opts, page) {
 exports.create = function (opts) {
     return decorateNewPage(opts, phantom.createWebPage());
 };
+
+/**
+ * pool of pages: instead of being closed, pages are handed back to the pool,
+ * reset and handed out again
+ * @param   {object}    opts    options for the pages created by the pool
+ * @param   {number}    maxIdle most pages kept for reuse, default 4: pages
+ *                              released beyond that are closed
+ * @return  {object}            "acquire()" a page, "release(page)" it, "close()" the pool
+ */
+exports.createPool = function (opts, maxIdle) {
+    var idle = [];
+
+    maxIdle = typeof maxIdle === 'number' ? maxIdle : 4;
+
+    return {
+        acquire: function () {
+            return idle.length > 0 ? idle.pop() : exports.create(opts);
+        },
+        release: function (page) {
+            // Released twice, it would be handed out twice
+            if (idle.indexOf(page) !== -1) {
+                return;
+            }
+            if (idle.length >= maxIdle) {
+                page.close();
+                return;
+            }
+            page.reset();
+            idle.push(page);
+        },
+        close: function () {
+            while (idle.length > 0) {
+                idle.pop().close();
+            }
+        }
+    };
+};
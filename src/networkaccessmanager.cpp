@@ -42,6 +42,7 @@
 #include "config.h"
 #include "cookiejar.h"
 #include "networkaccessmanager.h"
+#include "metrics.h"
 #include <string>
 #include <string>
 #include <sstream>
@@ -277,6 +278,7 @@ NetworkAccessManager::NetworkAccessManager(QObject *parent, const Config *config
     , m_authAttempts(0)
     , m_maxAuthAttempts(3)
     , m_resourceTimeout(0)
+    , m_networkIdleTime(500)
     , m_idCounter(0)
     , m_networkDiskCache(0)
     , m_sslConfiguration(QSslConfiguration::defaultConfiguration())
@@ -319,6 +321,9 @@ NetworkAccessManager::NetworkAccessManager(QObject *parent, const Config *config
 
     connect(this, SIGNAL(authenticationRequired(QNetworkReply*,QAuthenticator*)), SLOT(provideAuthentication(QNetworkReply*,QAuthenticator*)));
     connect(this, SIGNAL(finished(QNetworkReply*)), SLOT(handleFinished(QNetworkReply*)));
+
+    m_networkIdleTimer.setSingleShot(true);
+    connect(&m_networkIdleTimer, SIGNAL(timeout()), SIGNAL(networkIdle()));
 }
 
 void NetworkAccessManager::setUserName(const QString &userName)
@@ -336,6 +341,13 @@ void NetworkAccessManager::setResourceTimeout(int resourceTimeout)
     m_resourceTimeout = resourceTimeout;
 }
 
+void NetworkAccessManager::setNetworkIdleTime(int networkIdleTime)
+{
+    m_networkIdleTime = networkIdleTime;
+    if (m_networkIdleTime <= 0)
+        m_networkIdleTimer.stop();
+}
+
 void NetworkAccessManager::setMaxAuthAttempts(int maxAttempts)
 {
     m_maxAuthAttempts = maxAttempts;
@@ -351,6 +363,25 @@ QVariantMap NetworkAccessManager::customHeaders() const
     return m_customHeaders;
 }
 
+void NetworkAccessManager::reset()
+{
+    // NOTE: Connections (and their keep-alive) are left untouched on purpose
+    m_userName.clear();
+    m_password.clear();
+    m_authAttempts = 0;
+    m_maxAuthAttempts = 3;
+    m_resourceTimeout = 0;
+    m_networkIdleTime = 500;
+    m_networkIdleTimer.stop();
+    m_customHeaders.clear();
+}
+
+void NetworkAccessManager::startNetworkIdleTimer()
+{
+    if (m_networkIdleTime > 0 && m_ids.isEmpty())
+        m_networkIdleTimer.start(m_networkIdleTime);
+}
+
 void NetworkAccessManager::setCookieJar(QNetworkCookieJar *cookieJar)
 {
     QNetworkAccessManager::setCookieJar(cookieJar);
@@ -442,6 +473,7 @@ QNetworkReply *NetworkAccessManager::createRequest(Operation op, const QNetworkR
     }
 
     m_idCounter++;
+    m_networkIdleTimer.stop();
 
     QVariantList headers;
     foreach (QByteArray headerName, req.rawHeaderList()) {
@@ -469,6 +501,7 @@ QNetworkReply *NetworkAccessManager::createRequest(Operation op, const QNetworkR
     //printf("\n Url currelty looking up --> %s \n",url.data());
     JsNetworkRequest jsNetworkRequest(&req, this);
     emit resourceRequested(data, &jsNetworkRequest);
+    Metrics::instance()->recordResourceRequested();
 
     // Pass duty to the superclass - Nothing special to do here (yet?)
     QNetworkReply *reply = QNetworkAccessManager::createRequest(op, req, outgoingData);
@@ -492,6 +525,7 @@ QNetworkReply *NetworkAccessManager::createRequest(Operation op, const QNetworkR
     m_ids[reply] = m_idCounter;
 
     connect(reply, SIGNAL(readyRead()), this, SLOT(handleStarted()));
+    connect(reply, SIGNAL(downloadProgress(qint64, qint64)), this, SLOT(handleDownloadProgress(qint64)));
     connect(reply, SIGNAL(sslErrors(const QList<QSslError> &)), this, SLOT(handleSslErrors(const QList<QSslError> &)));
     connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(handleNetworkError()));
 
@@ -509,11 +543,24 @@ void NetworkAccessManager::handleTimeout()
     nt->data["errorString"] = "Network timeout on resource.";
 
     emit resourceTimeout(nt->data);
+    Metrics::instance()->recordResourceTimeout();
 
     // Abort the reply that we attached to the Network Timeout
     nt->reply->abort();
 }
 
+void NetworkAccessManager::handleDownloadProgress(qint64 bytesReceived)
+{
+    QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+    if (!reply)
+        return;
+
+    // Progress is cumulative: only count what is new
+    qint64 &counted = m_bytesReceived[reply];
+    Metrics::instance()->recordResourceBytes(bytesReceived - counted);
+    counted = bytesReceived;
+}
+
 void NetworkAccessManager::handleStarted()
 {
     QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
@@ -555,6 +602,7 @@ void NetworkAccessManager::handleFinished(QNetworkReply *reply)
     QVariant status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute);
     QVariant statusText = reply->attribute(QNetworkRequest::HttpReasonPhraseAttribute);
 
+    Metrics::instance()->recordResourceReceived();
     this->handleFinished(reply, status, statusText);
 }
 
@@ -596,8 +644,10 @@ void NetworkAccessManager::handleFinished(QNetworkReply *reply, const QVariant &
 
     m_ids.remove(reply);
     m_started.remove(reply);
+    m_bytesReceived.remove(reply);
 
     emit resourceReceived(data);
+    startNetworkIdleTimer();
 }
 
 void NetworkAccessManager::handleSslErrors(const QList<QSslError> &errors)
@@ -626,4 +676,5 @@ void NetworkAccessManager::handleNetworkError()
     data["errorString"] = reply->errorString();
 
     emit resourceError(data);
+    Metrics::instance()->recordResourceError();
 }
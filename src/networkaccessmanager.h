@@ -76,8 +76,20 @@ public:
     void setPassword(const QString &password);
     void setMaxAuthAttempts(int maxAttempts);
     void setResourceTimeout(int resourceTimeout);
+    void setNetworkIdleTime(int networkIdleTime);
     void setCustomHeaders(const QVariantMap &headers);
     QVariantMap customHeaders() const;
+    /**
+     * Forget the per-page state (credentials, custom headers, timeouts)
+     * so the manager can serve another page.
+     */
+    void reset();
+    /**
+     * Start counting towards "networkIdle" if no request is in flight.
+     * Requests finishing do that already: this covers the loads that
+     * need no request at all.
+     */
+    void startNetworkIdleTimer();
 
     void setCookieJar(QNetworkCookieJar *cookieJar);
 
@@ -86,6 +98,7 @@ protected:
     int m_authAttempts;
     int m_maxAuthAttempts;
     int m_resourceTimeout;
+    int m_networkIdleTime;
     QString m_userName;
     QString m_password;
     QNetworkReply *createRequest(Operation op, const QNetworkRequest & req, QIODevice * outgoingData = 0);
@@ -96,6 +109,7 @@ signals:
     void resourceReceived(const QVariant& data);
     void resourceError(const QVariant& data);
     void resourceTimeout(const QVariant& data);
+    void networkIdle();
 
 private slots:
     void handleStarted();
@@ -104,14 +118,17 @@ private slots:
     void handleSslErrors(const QList<QSslError> &errors);
     void handleNetworkError();
     void handleTimeout();
+    void handleDownloadProgress(qint64 bytesReceived);
 
 private:
     QHash<QNetworkReply*, int> m_ids;
     QSet<QNetworkReply*> m_started;
+    QHash<QNetworkReply*, qint64> m_bytesReceived;
     int m_idCounter;
     QNetworkDiskCache* m_networkDiskCache;
     QVariantMap m_customHeaders;
     QSslConfiguration m_sslConfiguration;
+    QTimer m_networkIdleTimer;
 };
 
 #endif // NETWORKACCESSMANAGER_H
@@ -30,11 +30,14 @@
 
 #include "phantom.h"
 
+#include <climits>
+
 #include <QApplication>
 #include <QDir>
 #include <QFileInfo>
 #include <QFile>
 #include <QWebPage>
+#include <QWebSettings>
 #include <QDebug>
 #include <QMetaObject>
 #include <QMetaProperty>
@@ -49,9 +52,18 @@
 #include "callback.h"
 #include "cookiejar.h"
 #include "childprocess.h"
+#include "forkserver.h"
+#include "metrics.h"
+#include "DumpRenderTreeSupportQt.h"
 
 static Phantom *phantomInstance = NULL;
 
+// Converts a size option in KB, capping it to the int the memory cache takes.
+static int kilobytesToBytes(int kilobytes)
+{
+    return static_cast<int>(qMin<qint64>(static_cast<qint64>(kilobytes) * 1024, INT_MAX));
+}
+
 // private:
 Phantom::Phantom(QObject *parent)
     : QObject(parent)
@@ -96,9 +108,68 @@ void Phantom::init()
         return;
     }
 
+    // These options need support built into JavaScriptCore: refuse them rather than run without it
+    QStringList unavailableOptions;
+    if (m_config.dfgJitEnabled() && !DumpRenderTreeSupportQt::javaScriptDFGJITAvailable()) {
+        unavailableOptions << "'dfg-jit': not built with the DFG JIT (ENABLE_DFG_JIT=1)";
+    }
+    if (m_config.gcMarkingThreads() > 1 && !DumpRenderTreeSupportQt::javaScriptParallelMarkingAvailable()) {
+        unavailableOptions << "'gc-marking-threads' above 1: not built with parallel marking (ENABLE_PARALLEL_GC=1)";
+    }
+    if (m_config.gcGenerational() && !DumpRenderTreeSupportQt::javaScriptGenerationalGCAvailable()) {
+        unavailableOptions << "'gc-generational': not built with generational collection (ENABLE_GGC=1)";
+    }
+    if (!unavailableOptions.isEmpty()) {
+        foreach (const QString &option, unavailableOptions) {
+            Terminal::instance()->cerr(QString("Unavailable option %1.").arg(option));
+        }
+        m_terminated = true;
+        m_returnValue = -1;
+        return;
+    }
+
     // Initialize the CookieJar
     CookieJar::instance(m_config.cookiesFile());
 
+    // Start collecting Metrics
+    Metrics::instance();
+
+    // JavaScriptCore reads these when the first page creates the shared JS global data
+    if (m_config.dfgJitEnabled()) {
+        qputenv("JavaScriptCoreUseDFGJIT", "1");
+    }
+    if (m_config.gcMarkingThreads() > 1) {
+        qputenv("JavaScriptCoreGCMarkingThreads", QByteArray::number(m_config.gcMarkingThreads()));
+    }
+    if (m_config.gcGenerational()) {
+        qputenv("JavaScriptCoreUseGenerationalGC", "1");
+    }
+    if (m_config.regExpCacheSize() > 0) {
+        qputenv("JavaScriptCoreRegExpCacheSize", QByteArray::number(m_config.regExpCacheSize()));
+    }
+    if (m_config.regExpCacheMaxPatternLength() > 0) {
+        qputenv("JavaScriptCoreRegExpCacheMaxPatternLength", QByteArray::number(m_config.regExpCacheMaxPatternLength()));
+    }
+
+    if (!m_config.scriptCachePath().isEmpty()) {
+        DumpRenderTreeSupportQt::setScriptParseCacheDirectory(m_config.scriptCachePath());
+    }
+    if (m_config.imageDecodingThreads() >= 0) {
+        DumpRenderTreeSupportQt::setImageDecodingThreadCount(m_config.imageDecodingThreads());
+    }
+    if (m_config.maxDecodedImageArea() > 0) {
+        DumpRenderTreeSupportQt::setMaxDecodedImageArea(m_config.maxDecodedImageArea());
+    }
+    if (m_config.memoryCacheSize() >= 0 || m_config.memoryCacheDeadSize() >= 0) {
+        // WebCore's default is 8 MB, which dead resources may take all of
+        int deadSize = kilobytesToBytes(m_config.memoryCacheDeadSize());
+        int size = m_config.memoryCacheSize() >= 0 ? kilobytesToBytes(m_config.memoryCacheSize()) : qMax(8192 * 1024, deadSize);
+        setMemoryCacheCapacities(0, m_config.memoryCacheDeadSize() >= 0 ? deadSize : size, size);
+    }
+    if (m_config.maxPagesInCache() >= 0) {
+        QWebSettings::setMaximumPagesInCache(m_config.maxPagesInCache());
+    }
+
     m_page = new WebPage(this, QUrl::fromLocalFile(m_config.scriptFile()));
     m_pages.append(m_page);
 
@@ -142,6 +213,10 @@ void Phantom::init()
     m_defaultPageSettings[PAGE_SETTINGS_WEB_SECURITY_ENABLED] = QVariant::fromValue(m_config.webSecurityEnabled());
     m_defaultPageSettings[PAGE_SETTINGS_JS_CAN_OPEN_WINDOWS] = QVariant::fromValue(m_config.javascriptCanOpenWindows());
     m_defaultPageSettings[PAGE_SETTINGS_JS_CAN_CLOSE_WINDOWS] = QVariant::fromValue(m_config.javascriptCanCloseWindows());
+    m_defaultPageSettings[PAGE_SETTINGS_MAX_REQUESTS_PER_HOST] = QVariant::fromValue(0);
+    m_defaultPageSettings[PAGE_SETTINGS_RESOURCE_PRIORITIES] = QVariantList();
+    m_defaultPageSettings[PAGE_SETTINGS_NETWORK_IDLE_TIME] = QVariant::fromValue(500);
+    m_defaultPageSettings[PAGE_SETTINGS_VISUALLY_COMPLETE_TIME] = QVariant::fromValue(500);
     m_page->applySettings(m_defaultPageSettings);
 
     setLibraryPath(QFileInfo(m_config.scriptFile()).dir().absolutePath());
@@ -209,6 +284,19 @@ bool Phantom::execute()
             m_returnValue = -1;
             return false;
         }
+    } else if (m_config.isForkServerMode()) {                           // Fork Server mode requested
+        qDebug() << "Phantom - execute: Starting Fork Server mode";
+
+        if (!ForkServer::instance()->listen(m_config.forkServer())) {
+            m_returnValue = -1;
+            return false;
+        }
+    } else if (m_config.isForkClientMode()) {                           // Fork Server request
+        qDebug() << "Phantom - execute: Running the script in a Fork Server worker";
+
+        // Nothing more to run here: main() returns the worker's exit code
+        m_returnValue = ForkServer::request(m_config.forkClient(), QDir::currentPath(), m_config.scriptFile(), m_config.scriptArgs());
+        return false;
     } else if (m_config.scriptFile().isEmpty()) {                       // REPL mode requested
         qDebug() << "Phantom - execute: Starting REPL mode";
 
@@ -235,6 +323,33 @@ bool Phantom::execute()
     return !m_terminated;
 }
 
+bool Phantom::executeForked(const QString &scriptFile, const QStringList &scriptArgs)
+{
+    if (m_terminated)
+        return false;
+
+    qDebug() << "Phantom - executeForked: Script & Arguments";
+    qDebug() << "    " << "script:" << scriptFile;
+
+    m_config.setScriptFile(scriptFile);
+    m_config.setScriptArgs(scriptArgs);
+    if (m_system) {
+        // The bootstrap already created the `system` module for the warm instance
+        QStringList systemArgs;
+        systemArgs += m_config.scriptFile();
+        systemArgs += m_config.scriptArgs();
+        m_system->setArgs(systemArgs);
+    }
+    setLibraryPath(QFileInfo(m_config.scriptFile()).dir().absolutePath());
+
+    if (!Utils::injectJsInFrame(m_config.scriptFile(), m_scriptFileEnc, QDir::currentPath(), m_page->mainFrame(), true)) {
+        m_returnValue = -1;
+        return false;
+    }
+
+    return !m_terminated;
+}
+
 int Phantom::returnValue() const
 {
     return m_returnValue;
@@ -298,6 +413,18 @@ bool Phantom::webdriverMode() const
     return m_config.isWebdriverMode();
 }
 
+QVariantMap Phantom::metrics() const
+{
+    // Event loop lag is sampled from the first read on
+    Metrics::instance()->startEventLoopProbe();
+    return Metrics::instance()->toMap();
+}
+
+QVariantMap Phantom::heapStatistics() const
+{
+    return DumpRenderTreeSupportQt::javaScriptHeapStatistics();
+}
+
 // public slots:
 QObject *Phantom::createWebPage()
 {
@@ -456,6 +583,34 @@ void Phantom::clearCookies()
     CookieJar::instance()->clearCookies();
 }
 
+QVariantMap Phantom::gc()
+{
+    DumpRenderTreeSupportQt::garbageCollectorCollect();
+    return heapStatistics();
+}
+
+QVariantMap Phantom::memoryStats(const bool objectCounts)
+{
+    QVariantMap stats = DumpRenderTreeSupportQt::memoryStatistics();
+    if (objectCounts) {
+        stats["jsObjectCounts"] = DumpRenderTreeSupportQt::javaScriptObjectTypeCounts();
+    }
+    return stats;
+}
+
+void Phantom::setMemoryCacheCapacities(int minDeadCapacity, int maxDeadCapacity, int totalCapacity)
+{
+    totalCapacity = qMax(0, totalCapacity);
+    maxDeadCapacity = qBound(0, maxDeadCapacity, totalCapacity);
+    minDeadCapacity = qBound(0, minDeadCapacity, maxDeadCapacity);
+    QWebSettings::setObjectCacheCapacities(minDeadCapacity, maxDeadCapacity, totalCapacity);
+}
+
+void Phantom::pruneMemoryCache(const double fraction)
+{
+    DumpRenderTreeSupportQt::pruneMemoryCache(fraction);
+}
+
 
 // private:
 void Phantom::doExit(int code)
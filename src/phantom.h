@@ -57,6 +57,8 @@ class Phantom : public QObject
     Q_PROPERTY(bool cookiesEnabled READ areCookiesEnabled WRITE setCookiesEnabled)
     Q_PROPERTY(QVariantList cookies READ cookies WRITE setCookies)
     Q_PROPERTY(bool webdriverMode READ webdriverMode)
+    Q_PROPERTY(QVariantMap metrics READ metrics)
+    Q_PROPERTY(QVariantMap heapStatistics READ heapStatistics)
 
 private:
     // Private constructor: the Phantom class is a singleton
@@ -75,6 +77,17 @@ public:
     void setOutputEncoding(const QString &encoding);
 
     bool execute();
+    /**
+     * Run a script in a worker forked by the ForkServer.
+     * The instance is already initialized and bootstrapped: only the script
+     * and its arguments have to be set before it is evaluated.
+     *
+     * @brief executeForked
+     * @param scriptFile Path to the script, relative to the current directory
+     * @param scriptArgs Arguments of the script
+     * @return Boolean "true" if the script was started
+     */
+    bool executeForked(const QString &scriptFile, const QStringList &scriptArgs);
     int returnValue() const;
 
     QString libraryPath() const;
@@ -102,6 +115,20 @@ public:
 
     bool webdriverMode() const;
 
+    /**
+     * Process-wide performance counters (pages, resources, rendering,
+     * JavaScriptCore heap, event loop lag).
+     *
+     * @see Metrics
+     */
+    QVariantMap metrics() const;
+
+    /**
+     * Size and collection counters of the JavaScriptCore heap.
+     * The same as `metrics.jsHeap`, without gathering the other counters.
+     */
+    QVariantMap heapStatistics() const;
+
     /**
      * Create `child_process` module instance
      */
@@ -166,6 +193,49 @@ public slots:
      */
     void clearCookies();
 
+    /**
+     * Collect garbage in the JavaScript heap now.
+     * Collections otherwise happen when enough has been allocated, or once
+     * the event loop goes idle after heavy allocation: a script can call this
+     * between two time-critical steps instead.
+     *
+     * @brief gc
+     * @return The heap statistics after the collection
+     */
+    QVariantMap gc();
+
+    /**
+     * Where the memory of the process goes: the JavaScript heap, JIT code,
+     * the memory cache of resources and the font caches. Sizes are in bytes.
+     *
+     * @brief memoryStats
+     * @param objectCounts Whether to add the number of live JavaScript objects by class,
+     *                     which needs a full garbage collection
+     * @return The memory breakdown
+     */
+    QVariantMap memoryStats(const bool objectCounts = false);
+
+    /**
+     * Sizes the memory cache of decoded resources (images, style sheets,
+     * scripts, fonts), in bytes. Resources that no page uses any more are
+     * "dead": they take between minDeadCapacity and maxDeadCapacity of the
+     * totalCapacity, depending on what the live ones leave.
+     * All three at 0 disable the cache.
+     *
+     * @brief setMemoryCacheCapacities
+     */
+    void setMemoryCacheCapacities(int minDeadCapacity, int maxDeadCapacity, int totalCapacity);
+
+    /**
+     * Flushes the memory cache down to the given fraction of its size, for
+     * instance between two page loads. Dead resources go first; the ones
+     * pages still use only lose their decoded data. 0 flushes all it can.
+     *
+     * @brief pruneMemoryCache
+     * @param fraction Between 0 and 1
+     */
+    void pruneMemoryCache(const double fraction = 0);
+
     // exit() will not exit in debug mode. debugExit() will always exit.
     void exit(int code = 0);
     void debugExit(int code = 0);
@@ -26,7 +26,9 @@ HEADERS += csconverter.h \
     encoding.h \
     config.h \
     childprocess.h \
-    repl.h
+    repl.h \
+    forkserver.h \
+    metrics.h
 
 SOURCES += phantom.cpp \
     callback.cpp \
@@ -44,7 +46,9 @@ SOURCES += phantom.cpp \
     encoding.cpp \
     config.cpp \
     childprocess.cpp \
-    repl.cpp
+    repl.cpp \
+    forkserver.cpp \
+    metrics.cpp
 
 OTHER_FILES += \
     bootstrap.js \
@@ -55,6 +59,9 @@ OTHER_FILES += \
     modules/child_process.js \
     repl.js
 
+# Hooks into QtWebKit internals (e.g. JavaScriptCore heap statistics)
+INCLUDEPATH += qt/src/3rdparty/webkit/Source/WebKit/qt/WebCoreSupport
+
 include(gif/gif.pri)
 include(mongoose/mongoose.pri)
 include(linenoise/linenoise.pri)
@@ -67,7 +67,7 @@ void HandleHeap::markStrongHandles(HeapRootVisitor& heapRootMarker)
         heapRootMarker.mark(node->slot());
 }
 
-void HandleHeap::markWeakHandles(HeapRootVisitor& heapRootVisitor)
+void HandleHeap::markWeakHandles(HeapRootVisitor& heapRootVisitor, WeakMarkingMode mode)
 {
     SlotVisitor& visitor = heapRootVisitor.visitor();
 
@@ -82,7 +82,7 @@ void HandleHeap::markWeakHandles(HeapRootVisitor& heapRootVisitor)
         if (!weakOwner)
             continue;
 
-        if (!weakOwner->isReachableFromOpaqueRoots(Handle<Unknown>::wrapSlot(node->slot()), node->weakOwnerContext(), visitor))
+        if (mode == MarkReachableWeakHandles && !weakOwner->isReachableFromOpaqueRoots(Handle<Unknown>::wrapSlot(node->slot()), node->weakOwnerContext(), visitor))
             continue;
 
         heapRootVisitor.mark(node->slot());
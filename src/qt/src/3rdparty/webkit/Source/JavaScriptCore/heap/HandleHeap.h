@@ -62,8 +62,12 @@ public:
     void makeWeak(HandleSlot, WeakHandleOwner* = 0, void* context = 0);
     HandleSlot copyWeak(HandleSlot);
 
+    // A minor collection does not revisit old cells, so it misses opaque roots:
+    // it keeps every weak handle that has an owner, until the next full collection.
+    enum WeakMarkingMode { MarkReachableWeakHandles, MarkAllOwnedWeakHandles };
+
     void markStrongHandles(HeapRootVisitor&);
-    void markWeakHandles(HeapRootVisitor&);
+    void markWeakHandles(HeapRootVisitor&, WeakMarkingMode = MarkReachableWeakHandles);
     void finalizeWeakHandles();
 
     void writeBarrier(HandleSlot, const JSValue&);
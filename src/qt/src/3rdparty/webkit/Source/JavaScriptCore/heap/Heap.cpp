@@ -31,6 +31,7 @@
 #include "JSONObject.h"
 #include "Tracing.h"
 #include <algorithm>
+#include <wtf/CurrentTime.h>
 
 #define COLLECT_ON_EVERY_SLOW_ALLOCATION 0
 
@@ -39,6 +40,7 @@ using namespace std;
 namespace JSC {
 
 const size_t minBytesPerCycle = 512 * 1024;
+const size_t maxBytesPerMinorCycle = 16 * 1024 * 1024;
 
 Heap::Heap(JSGlobalData* globalData)
     : m_operationInProgress(NoOperation)
@@ -47,10 +49,23 @@ Heap::Heap(JSGlobalData* globalData)
     , m_activityCallback(DefaultGCActivityCallback::create(this))
     , m_globalData(globalData)
     , m_machineThreads(this)
-    , m_markStack(globalData->jsArrayVPtr)
+    , m_sharedData(globalData->jsArrayVPtr)
+    , m_markStack(m_sharedData)
     , m_handleHeap(globalData)
     , m_extraCost(0)
+    , m_isGenerational(false)
+    , m_sizeAfterLastFullCollection(0)
+    , m_collectionCount(0)
+    , m_minorCollectionCount(0)
+    , m_totalCollectionTime(0)
+    , m_lastCollectionTime(0)
+    , m_totalMarkingTime(0)
+    , m_lastMarkingTime(0)
 {
+#if ENABLE(GGC)
+    char* useGenerationalGCString = getenv("JavaScriptCoreUseGenerationalGC");
+    m_isGenerational = useGenerationalGCString && atoi(useGenerationalGCString);
+#endif
     m_markedSpace.setHighWaterMark(minBytesPerCycle);
     (*m_activityCallback)();
 }
@@ -119,7 +134,7 @@ void* Heap::allocateSlowCase(size_t bytes)
     ASSERT(m_operationInProgress == NoOperation);
 #endif
 
-    reset(DoNotSweep);
+    reset(DoNotSweep, nextCollectionType());
 
     m_operationInProgress = Allocation;
     void* result = m_markedSpace.allocate(bytes);
@@ -190,7 +205,45 @@ inline RegisterFile& Heap::registerFile()
     return m_globalData->interpreter->registerFile();
 }
 
-void Heap::markRoots()
+Heap::CollectionType Heap::nextCollectionType()
+{
+#if ENABLE(GGC)
+    // Minor collections never free old cells: fall back to a full collection
+    // once the heap has doubled since the last one.
+    if (m_isGenerational && m_markedSpace.size() <= 2 * m_sizeAfterLastFullCollection)
+        return MinorCollection;
+#endif
+    return FullCollection;
+}
+
+#if ENABLE(GGC)
+class DirtyCellVisitor {
+public:
+    DirtyCellVisitor(HeapRootVisitor& heapRootMarker)
+        : m_heapRootMarker(heapRootMarker)
+    {
+    }
+
+    void operator()(JSCell* cell) { m_heapRootMarker.markChildren(cell); }
+
+private:
+    HeapRootVisitor& m_heapRootMarker;
+};
+#endif
+
+void Heap::markDirtyCells(HeapRootVisitor& heapRootMarker)
+{
+#if ENABLE(GGC)
+    // Old cells are all still marked: revisit those sharing a block with a cell
+    // the write barrier has seen, as they may point to young cells.
+    DirtyCellVisitor dirtyCellVisitor(heapRootMarker);
+    m_markedSpace.forEachCellInDirtyBlocks(dirtyCellVisitor);
+#else
+    UNUSED_PARAM(heapRootMarker);
+#endif
+}
+
+void Heap::markRoots(CollectionType collectionType)
 {
 #ifndef NDEBUG
     if (m_globalData->isSharedInstance()) {
@@ -207,6 +260,8 @@ void Heap::markRoots()
 
     m_operationInProgress = Collection;
 
+    double startTime = WTF::currentTime();
+
     MarkStack& visitor = m_markStack;
     HeapRootVisitor heapRootMarker(visitor);
     
@@ -219,7 +274,14 @@ void Heap::markRoots()
     ConservativeRoots registerFileRoots(this);
     registerFile().gatherConservativeRoots(registerFileRoots);
 
-    m_markedSpace.clearMarks();
+#if ENABLE(GGC)
+    if (collectionType == MinorCollection) {
+        m_markedSpace.clearYoungMarks();
+        markDirtyCells(heapRootMarker);
+        visitor.drain();
+    } else
+#endif
+        m_markedSpace.clearMarks();
 
     visitor.append(machineThreadRoots);
     visitor.drain();
@@ -245,24 +307,34 @@ void Heap::markRoots()
     m_handleStack.mark(heapRootMarker);
     visitor.drain();
 
+    // Wait for the GC helper threads, if any: the small strings cache looks
+    // at mark bits to decide whether it has been used.
+    visitor.drainFromShared(MarkStack::MasterDrain);
+
     // Mark the small strings cache as late as possible, since it will clear
     // itself if nothing else has marked it.
     // FIXME: Change the small strings cache to use Weak<T>.
     m_globalData->smallStrings.visitChildren(heapRootMarker);
     visitor.drain();
+    visitor.drainFromShared(MarkStack::MasterDrain);
     
     // Weak handles must be marked last, because their owners use the set of
     // opaque roots to determine reachability.
+    HandleHeap::WeakMarkingMode weakMarkingMode = collectionType == MinorCollection ? HandleHeap::MarkAllOwnedWeakHandles : HandleHeap::MarkReachableWeakHandles;
     int lastOpaqueRootCount;
     do {
         lastOpaqueRootCount = visitor.opaqueRootCount();
-        m_handleHeap.markWeakHandles(heapRootMarker);
+        m_handleHeap.markWeakHandles(heapRootMarker, weakMarkingMode);
         visitor.drain();
+        visitor.drainFromShared(MarkStack::MasterDrain);
     // If the set of opaque roots has grown, more weak handles may have become reachable.
     } while (lastOpaqueRootCount != visitor.opaqueRootCount());
 
     visitor.reset();
 
+    m_lastMarkingTime = WTF::currentTime() - startTime;
+    m_totalMarkingTime += m_lastMarkingTime;
+
     m_operationInProgress = NoOperation;
 }
 
@@ -389,12 +461,39 @@ void Heap::collectAllGarbage()
     reset(DoSweep);
 }
 
-void Heap::reset(SweepToggle sweepToggle)
+void Heap::collectAllGarbageIncrementally()
+{
+    if (!m_globalData->dynamicGlobalObject)
+        m_globalData->recompileAllJSFunctions();
+
+    reset(DoNotSweep);
+    m_markedSpace.prepareIncrementalSweep();
+}
+
+bool Heap::sweepIncrementally(double maxTime)
+{
+    ASSERT(globalData()->identifierTable == wtfThreadData().currentIdentifierTable());
+    ASSERT(m_operationInProgress == NoOperation);
+
+    m_operationInProgress = Collection;
+    bool done = m_markedSpace.sweepIncrementally(WTF::currentTime() + maxTime);
+    m_operationInProgress = NoOperation;
+
+    // Give back the blocks left empty, now that their dead cells are gone.
+    if (done)
+        m_markedSpace.shrink();
+
+    return done;
+}
+
+void Heap::reset(SweepToggle sweepToggle, CollectionType collectionType)
 {
     ASSERT(globalData()->identifierTable == wtfThreadData().currentIdentifierTable());
     JAVASCRIPTCORE_GC_BEGIN();
 
-    markRoots();
+    double startTime = WTF::currentTime();
+
+    markRoots(collectionType);
     m_handleHeap.finalizeWeakHandles();
 
     JAVASCRIPTCORE_GC_MARKED();
@@ -415,8 +514,21 @@ void Heap::reset(SweepToggle sweepToggle)
     // water mark to be proportional to the current size of the heap. The exact
     // proportion is a bit arbitrary. A 2X multiplier gives a 1:1 (heap size :
     // new bytes allocated) proportion, and seems to work well in benchmarks.
-    size_t proportionalBytes = 2 * m_markedSpace.size();
-    m_markedSpace.setHighWaterMark(max(proportionalBytes, minBytesPerCycle));
+    if (collectionType == FullCollection) {
+        size_t proportionalBytes = 2 * m_markedSpace.size();
+        m_markedSpace.setHighWaterMark(max(proportionalBytes, minBytesPerCycle));
+        m_sizeAfterLastFullCollection = m_markedSpace.size();
+    } else {
+        // Minor collections are cheap as long as few cells survive them: give the
+        // young generation a bounded budget on top of the blocks already in use.
+        size_t youngBytes = min(max(m_markedSpace.size() / 4, minBytesPerCycle), maxBytesPerMinorCycle);
+        m_markedSpace.setHighWaterMark(m_markedSpace.capacity() + youngBytes);
+        ++m_minorCollectionCount;
+    }
+
+    m_lastCollectionTime = WTF::currentTime() - startTime;
+    m_totalCollectionTime += m_lastCollectionTime;
+    ++m_collectionCount;
 
     JAVASCRIPTCORE_GC_END();
 
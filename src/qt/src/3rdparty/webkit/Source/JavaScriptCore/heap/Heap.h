@@ -60,6 +60,9 @@ namespace JSC {
 
         static bool isMarked(const JSCell*);
         static bool testAndSetMarked(const JSCell*);
+#if ENABLE(PARALLEL_GC)
+        static bool concurrentTestAndSetMarked(const JSCell*);
+#endif
         static void setMarked(JSCell*);
         
         Heap(JSGlobalData*);
@@ -73,9 +76,19 @@ namespace JSC {
         GCActivityCallback* activityCallback();
         void setActivityCallback(PassOwnPtr<GCActivityCallback>);
 
+        // In generational mode, which has to be asked for, collections triggered by
+        // allocation only visit cells allocated since the previous collection and
+        // old cells that the write barrier has seen being modified.
+        bool isGenerational() const { return m_isGenerational; }
+
         bool isBusy(); // true if an allocation or collection is in progress
         void* allocate(size_t);
         void collectAllGarbage();
+        // Like collectAllGarbage(), but only marking is done right away: dead cells
+        // are then swept in slices by sweepIncrementally(), to keep pauses short.
+        void collectAllGarbageIncrementally();
+        // Sweeps for at most maxTime seconds. Returns true once the sweep is complete.
+        bool sweepIncrementally(double maxTime);
 
         void reportExtraMemoryCost(size_t cost);
 
@@ -87,6 +100,18 @@ namespace JSC {
         size_t size() const;
         size_t capacity() const;
         size_t objectCount() const;
+        size_t blockCount() const { return m_markedSpace.blockCount(); }
+        // The memory reported by reportExtraMemoryCost() since the last collection.
+        size_t extraCost() const { return m_extraCost; }
+
+        // Collection statistics: number of collections, and their pause times (in seconds).
+        size_t collectionCount() const { return m_collectionCount; }
+        size_t minorCollectionCount() const { return m_minorCollectionCount; }
+        double totalCollectionTime() const { return m_totalCollectionTime; }
+        double lastCollectionTime() const { return m_lastCollectionTime; }
+        double totalMarkingTime() const { return m_totalMarkingTime; }
+        double lastMarkingTime() const { return m_lastMarkingTime; }
+        unsigned markingThreadCount() const { return m_sharedData.numberOfMarkingThreads(); }
         size_t globalObjectCount();
         size_t protectedObjectCount();
         size_t protectedGlobalObjectCount();
@@ -114,12 +139,16 @@ namespace JSC {
         void* allocateSlowCase(size_t);
         void reportExtraMemoryCostSlowCase(size_t);
 
-        void markRoots();
+        enum CollectionType { FullCollection, MinorCollection };
+        CollectionType nextCollectionType();
+
+        void markRoots(CollectionType);
         void markProtectedObjects(HeapRootVisitor&);
         void markTempSortVectors(HeapRootVisitor&);
+        void markDirtyCells(HeapRootVisitor&);
 
         enum SweepToggle { DoNotSweep, DoSweep };
-        void reset(SweepToggle);
+        void reset(SweepToggle, CollectionType = FullCollection);
 
         RegisterFile& registerFile();
 
@@ -136,11 +165,22 @@ namespace JSC {
         JSGlobalData* m_globalData;
         
         MachineThreads m_machineThreads;
+        MarkStackThreadSharedData m_sharedData;
         MarkStack m_markStack;
         HandleHeap m_handleHeap;
         HandleStack m_handleStack;
 
         size_t m_extraCost;
+
+        bool m_isGenerational;
+        size_t m_sizeAfterLastFullCollection;
+
+        size_t m_collectionCount;
+        size_t m_minorCollectionCount;
+        double m_totalCollectionTime;
+        double m_lastCollectionTime;
+        double m_totalMarkingTime;
+        double m_lastMarkingTime;
     };
 
     inline bool Heap::isMarked(const JSCell* cell)
@@ -153,6 +193,13 @@ namespace JSC {
         return MarkedSpace::testAndSetMarked(cell);
     }
 
+#if ENABLE(PARALLEL_GC)
+    inline bool Heap::concurrentTestAndSetMarked(const JSCell* cell)
+    {
+        return MarkedSpace::concurrentTestAndSetMarked(cell);
+    }
+#endif
+
     inline void Heap::setMarked(JSCell* cell)
     {
         MarkedSpace::setMarked(cell);
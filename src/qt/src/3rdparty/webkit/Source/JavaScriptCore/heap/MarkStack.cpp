@@ -33,17 +33,80 @@
 #include "JSObject.h"
 #include "ScopeChain.h"
 #include "Structure.h"
+#include <algorithm>
+#include <stdlib.h>
 
 namespace JSC {
 
 size_t MarkStack::s_pageSize = 0;
 
+#if ENABLE(PARALLEL_GC)
+// Upper bound on JavaScriptCoreGCMarkingThreads.
+static const int maximumNumberOfMarkingThreads = 8;
+// A marking thread offers half of its cells to the others once it holds this many...
+static const size_t minimumNumberOfCellsToDonate = 128;
+// ...unless the shared mark stack already holds enough for everyone.
+static const size_t maximumNumberOfSharedCells = 4096;
+#endif
+
+MarkStackThreadSharedData::MarkStackThreadSharedData(void* jsArrayVPtr)
+    : m_jsArrayVPtr(jsArrayVPtr)
+    , m_numberOfActiveParallelMarkers(0)
+    , m_parallelMarkersShouldExit(false)
+{
+#if ENABLE(PARALLEL_GC)
+    // Marking happens on the collecting thread alone unless more threads are asked for.
+    char* markingThreadsString = getenv("JavaScriptCoreGCMarkingThreads");
+    int numberOfMarkingThreads = markingThreadsString ? atoi(markingThreadsString) : 1;
+    numberOfMarkingThreads = std::min(std::max(numberOfMarkingThreads, 1), maximumNumberOfMarkingThreads);
+
+    // The helpers take this lock before looking at m_markingThreads.
+    MutexLocker locker(m_markingLock);
+    for (int i = 1; i < numberOfMarkingThreads; ++i) {
+        ThreadIdentifier markingThread = createThread(markingThreadStartFunc, this, "JavaScriptCore::Marking");
+        if (!markingThread)
+            break;
+        m_markingThreads.append(markingThread);
+    }
+#endif
+}
+
+MarkStackThreadSharedData::~MarkStackThreadSharedData()
+{
+#if ENABLE(PARALLEL_GC)
+    {
+        MutexLocker locker(m_markingLock);
+        m_parallelMarkersShouldExit = true;
+        m_markingCondition.broadcast();
+    }
+    for (unsigned i = 0; i < m_markingThreads.size(); ++i)
+        waitForThreadCompletion(m_markingThreads[i], 0);
+#endif
+}
+
+#if ENABLE(PARALLEL_GC)
+void* MarkStackThreadSharedData::markingThreadStartFunc(void* sharedData)
+{
+    static_cast<MarkStackThreadSharedData*>(sharedData)->markingThreadMain();
+    return 0;
+}
+
+void MarkStackThreadSharedData::markingThreadMain()
+{
+    MarkStack markStack(*this);
+    // Only returns once the heap is being destroyed.
+    markStack.drainFromShared(MarkStack::SlaveDrain);
+}
+#endif
+
 void MarkStack::reset()
 {
     ASSERT(s_pageSize);
+    ASSERT(m_shared.m_sharedMarkStack.isEmpty());
     m_values.shrinkAllocation(s_pageSize);
     m_markSets.shrinkAllocation(s_pageSize);
-    m_opaqueRoots.clear();
+    m_shared.m_sharedMarkStack.shrinkAllocation(s_pageSize);
+    m_shared.m_opaqueRoots.clear();
 }
 
 void MarkStack::append(ConservativeRoots& conservativeRoots)
@@ -82,6 +145,32 @@ inline void MarkStack::visitChildren(JSCell* cell)
     cell->visitChildren(*this);
 }
 
+#if ENABLE(PARALLEL_GC)
+inline void MarkStack::donateKnownParallel()
+{
+    if (m_values.size() < minimumNumberOfCellsToDonate || !isParallel())
+        return;
+    donateSlow();
+}
+
+void MarkStack::donateSlow()
+{
+    // If another marker holds the lock it is probably taking cells already;
+    // we will get another chance after the next few cells.
+    if (!m_shared.m_markingLock.tryLock())
+        return;
+
+    if (m_shared.m_sharedMarkStack.size() < maximumNumberOfSharedCells) {
+        for (size_t numberToDonate = m_values.size() / 2; numberToDonate; --numberToDonate)
+            m_shared.m_sharedMarkStack.append(m_values.removeLast());
+        if (m_shared.m_numberOfActiveParallelMarkers < m_shared.numberOfMarkingThreads())
+            m_shared.m_markingCondition.broadcast();
+    }
+
+    m_shared.m_markingLock.unlock();
+}
+#endif
+
 void MarkStack::drain()
 {
 #if !ASSERT_DISABLED
@@ -102,7 +191,7 @@ void MarkStack::drain()
             current.m_values++;
 
             JSCell* cell;
-            if (!value || !value.isCell() || Heap::testAndSetMarked(cell = value.asCell())) {
+            if (!value || !value.isCell() || testAndSetMarked(cell = value.asCell())) {
                 if (current.m_values == end) {
                     m_markSets.removeLast();
                     continue;
@@ -124,12 +213,68 @@ void MarkStack::drain()
 
             visitChildren(cell);
         }
-        while (!m_values.isEmpty())
+        while (!m_values.isEmpty()) {
             visitChildren(m_values.removeLast());
+#if ENABLE(PARALLEL_GC)
+            donateKnownParallel();
+#endif
+        }
     }
 #if !ASSERT_DISABLED
     m_isDraining = false;
 #endif
 }
 
+void MarkStack::drainFromShared(SharedDrainMode sharedDrainMode)
+{
+#if ENABLE(PARALLEL_GC)
+    if (sharedDrainMode == MasterDrain && !isParallel())
+        return;
+
+    ASSERT(m_markSets.isEmpty());
+    ASSERT(m_values.isEmpty());
+
+    {
+        MutexLocker locker(m_shared.m_markingLock);
+        m_shared.m_numberOfActiveParallelMarkers++;
+    }
+
+    while (true) {
+        drain();
+
+        MutexLocker locker(m_shared.m_markingLock);
+        m_shared.m_numberOfActiveParallelMarkers--;
+
+        if (sharedDrainMode == MasterDrain) {
+            // Marking is done once nobody is visiting cells and none are left to take.
+            while (true) {
+                if (!m_shared.m_numberOfActiveParallelMarkers && m_shared.m_sharedMarkStack.isEmpty())
+                    return;
+                if (!m_shared.m_sharedMarkStack.isEmpty())
+                    break;
+                m_shared.m_markingCondition.wait(m_shared.m_markingLock);
+            }
+        } else {
+            ASSERT(sharedDrainMode == SlaveDrain);
+            // The last marker to run out of work tells the master that marking is done.
+            if (!m_shared.m_numberOfActiveParallelMarkers && m_shared.m_sharedMarkStack.isEmpty())
+                m_shared.m_markingCondition.broadcast();
+            while (m_shared.m_sharedMarkStack.isEmpty() && !m_shared.m_parallelMarkersShouldExit)
+                m_shared.m_markingCondition.wait(m_shared.m_markingLock);
+            if (m_shared.m_parallelMarkersShouldExit)
+                return;
+        }
+
+        // Take our share of the waiting cells, leaving some for the other markers.
+        size_t numberToSteal = std::max<size_t>(1, m_shared.m_sharedMarkStack.size() / m_shared.numberOfMarkingThreads());
+        for (; numberToSteal; --numberToSteal)
+            m_values.append(m_shared.m_sharedMarkStack.removeLast());
+
+        m_shared.m_numberOfActiveParallelMarkers++;
+    }
+#else
+    UNUSED_PARAM(sharedDrainMode);
+#endif
+}
+
 } // namespace JSC
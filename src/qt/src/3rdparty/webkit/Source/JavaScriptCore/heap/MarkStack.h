@@ -33,11 +33,13 @@
 #include <wtf/Vector.h>
 #include <wtf/Noncopyable.h>
 #include <wtf/OSAllocator.h>
+#include <wtf/Threading.h>
 
 namespace JSC {
 
     class ConservativeRoots;
     class JSGlobalData;
+    class MarkStackThreadSharedData;
     class Register;
     
     enum MarkSetProperties { MayContainNullValues, NoNullValues };
@@ -45,14 +47,7 @@ namespace JSC {
     class MarkStack {
         WTF_MAKE_NONCOPYABLE(MarkStack);
     public:
-        MarkStack(void* jsArrayVPtr)
-            : m_jsArrayVPtr(jsArrayVPtr)
-#if !ASSERT_DISABLED
-            , m_isCheckingForDefaultMarkViolation(false)
-            , m_isDraining(false)
-#endif
-        {
-        }
+        MarkStack(MarkStackThreadSharedData&);
 
         ~MarkStack()
         {
@@ -71,23 +66,36 @@ namespace JSC {
         
         void append(ConservativeRoots&);
 
-        bool addOpaqueRoot(void* root) { return m_opaqueRoots.add(root).second; }
-        bool containsOpaqueRoot(void* root) { return m_opaqueRoots.contains(root); }
-        int opaqueRootCount() { return m_opaqueRoots.size(); }
+        bool addOpaqueRoot(void*);
+        bool containsOpaqueRoot(void*);
+        int opaqueRootCount();
+
+        enum SharedDrainMode { SlaveDrain, MasterDrain };
 
         void drain();
+        // Keeps taking cells from the other marking threads until none of them
+        // has anything left to visit. A no-op unless GC helper threads are running.
+        void drainFromShared(SharedDrainMode);
         void reset();
 
     private:
         friend class HeapRootVisitor; // Allowed to mark a JSValue* or JSCell** directly.
+        friend class MarkStackThreadSharedData;
+
         void append(JSValue*);
         void append(JSValue*, size_t count);
         void append(JSCell**);
 
         void internalAppend(JSCell*);
         void internalAppend(JSValue);
+        void appendChildren(JSCell*);
         void visitChildren(JSCell*);
 
+        bool isParallel() const;
+        bool testAndSetMarked(JSCell*);
+        void donateKnownParallel();
+        void donateSlow();
+
         struct MarkSet {
             MarkSet(JSValue* values, JSValue* end, MarkSetProperties properties)
                 : m_values(values)
@@ -188,11 +196,11 @@ namespace JSC {
             T* m_data;
         };
 
+        MarkStackThreadSharedData& m_shared;
         void* m_jsArrayVPtr;
         MarkStackArray<MarkSet> m_markSets;
         MarkStackArray<JSCell*> m_values;
         static size_t s_pageSize;
-        HashSet<void*> m_opaqueRoots; // Handle-owning data structures not visible to the garbage collector.
 
 #if !ASSERT_DISABLED
     public:
@@ -203,6 +211,80 @@ namespace JSC {
 
     typedef MarkStack SlotVisitor;
 
+    // State shared between the MarkStack of the thread running a collection and
+    // those of the GC helper threads. Cells waiting to be visited are handed
+    // between threads through m_sharedMarkStack; it is guarded by m_markingLock.
+    // Helper threads are only started when JavaScriptCoreGCMarkingThreads asks
+    // for more than one marking thread.
+    class MarkStackThreadSharedData {
+        WTF_MAKE_NONCOPYABLE(MarkStackThreadSharedData);
+    public:
+        MarkStackThreadSharedData(void* jsArrayVPtr);
+        ~MarkStackThreadSharedData();
+
+        // Including the thread that runs the collection.
+        unsigned numberOfMarkingThreads() const { return m_markingThreads.size() + 1; }
+
+    private:
+        friend class MarkStack;
+
+#if ENABLE(PARALLEL_GC)
+        static void* markingThreadStartFunc(void* sharedData);
+        void markingThreadMain();
+#endif
+
+        void* m_jsArrayVPtr;
+        Vector<ThreadIdentifier> m_markingThreads;
+
+        Mutex m_markingLock;
+        ThreadCondition m_markingCondition;
+        MarkStack::MarkStackArray<JSCell*> m_sharedMarkStack;
+        unsigned m_numberOfActiveParallelMarkers;
+        bool m_parallelMarkersShouldExit;
+
+        Mutex m_opaqueRootsLock;
+        HashSet<void*> m_opaqueRoots; // Handle-owning data structures not visible to the garbage collector.
+    };
+
+    inline MarkStack::MarkStack(MarkStackThreadSharedData& shared)
+        : m_shared(shared)
+        , m_jsArrayVPtr(shared.m_jsArrayVPtr)
+#if !ASSERT_DISABLED
+        , m_isCheckingForDefaultMarkViolation(false)
+        , m_isDraining(false)
+#endif
+    {
+    }
+
+    inline bool MarkStack::isParallel() const
+    {
+        return !m_shared.m_markingThreads.isEmpty();
+    }
+
+    inline bool MarkStack::addOpaqueRoot(void* root)
+    {
+        if (!isParallel())
+            return m_shared.m_opaqueRoots.add(root).second;
+        MutexLocker locker(m_shared.m_opaqueRootsLock);
+        return m_shared.m_opaqueRoots.add(root).second;
+    }
+
+    inline bool MarkStack::containsOpaqueRoot(void* root)
+    {
+        if (!isParallel())
+            return m_shared.m_opaqueRoots.contains(root);
+        MutexLocker locker(m_shared.m_opaqueRootsLock);
+        return m_shared.m_opaqueRoots.contains(root);
+    }
+
+    inline int MarkStack::opaqueRootCount()
+    {
+        if (!isParallel())
+            return m_shared.m_opaqueRoots.size();
+        MutexLocker locker(m_shared.m_opaqueRootsLock);
+        return m_shared.m_opaqueRoots.size();
+    }
+
     inline void MarkStack::append(JSValue* slot, size_t count)
     {
         if (!count)
@@ -248,6 +330,8 @@ namespace JSC {
         void mark(JSValue*, size_t);
         void mark(JSString**);
         void mark(JSCell**);
+        // Visits the children of an already marked cell again.
+        void markChildren(JSCell*);
         
         SlotVisitor& visitor();
 
@@ -280,6 +364,11 @@ namespace JSC {
         m_visitor.append(slot);
     }
 
+    inline void HeapRootVisitor::markChildren(JSCell* cell)
+    {
+        m_visitor.appendChildren(cell);
+    }
+
     inline SlotVisitor& HeapRootVisitor::visitor()
     {
         return m_visitor;
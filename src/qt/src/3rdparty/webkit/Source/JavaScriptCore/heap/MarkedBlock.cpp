@@ -50,6 +50,9 @@ void MarkedBlock::destroy(MarkedBlock* block)
 
 MarkedBlock::MarkedBlock(const PageAllocationAligned& allocation, JSGlobalData* globalData, size_t cellSize)
     : m_nextAtom(firstAtom())
+#if ENABLE(GGC)
+    , m_dirty(0)
+#endif
     , m_allocation(allocation)
     , m_heap(&globalData->heap)
     , m_prev(0)
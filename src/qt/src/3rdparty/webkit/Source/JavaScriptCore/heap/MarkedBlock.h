@@ -39,6 +39,8 @@ namespace JSC {
     class MarkedBlock {
     public:
         static const size_t atomSize = sizeof(double); // Ensures natural alignment for all built-in types.
+        static const size_t blockSize = 16 * KB;
+        static const size_t blockMask = ~(blockSize - 1); // blockSize must be a power of two.
 
         static MarkedBlock* create(JSGlobalData*, size_t cellSize);
         static void destroy(MarkedBlock*);
@@ -72,14 +74,27 @@ namespace JSC {
         size_t atomNumber(const void*);
         bool isMarked(const void*);
         bool testAndSetMarked(const void*);
+#if ENABLE(PARALLEL_GC)
+        bool concurrentTestAndSetMarked(const void*);
+#endif
         void setMarked(const void*);
         
         template <typename Functor> void forEach(Functor&);
 
-    private:
-        static const size_t blockSize = 16 * KB;
-        static const size_t blockMask = ~(blockSize - 1); // blockSize must be a power of two.
+#if ENABLE(GGC)
+        // Cells allocated since the last collection are young. The write barrier
+        // marks a block dirty when an old cell in it may have been made to point
+        // at a young cell; minor collections revisit the old cells of dirty blocks.
+        bool isNewlyAllocated(const void*);
+        void setDirty();
+        bool isDirty();
+        void* addressOfDirty();
+        static ptrdiff_t offsetOfDirty();
+        void clearYoungMarks();
+        void resetGenerations();
+#endif
 
+    private:
         static const size_t atomMask = ~(atomSize - 1); // atomSize must be a power of two.
         
         static const size_t atomsPerBlock = blockSize / atomSize;
@@ -93,6 +108,10 @@ namespace JSC {
         size_t m_endAtom; // This is a fuzzy end. Always test for < m_endAtom.
         size_t m_atomsPerCell;
         WTF::Bitmap<blockSize / atomSize> m_marks;
+#if ENABLE(GGC)
+        WTF::Bitmap<blockSize / atomSize> m_newlyAllocated;
+        int32_t m_dirty; // 32 bits so that JIT code can set it with a plain store.
+#endif
         PageAllocationAligned m_allocation;
         Heap* m_heap;
         MarkedBlock* m_prev;
@@ -204,11 +223,58 @@ namespace JSC {
         return m_marks.testAndSet(atomNumber(p));
     }
 
+#if ENABLE(PARALLEL_GC)
+    // For when GC helper threads may be marking cells in this block at the same time.
+    inline bool MarkedBlock::concurrentTestAndSetMarked(const void* p)
+    {
+        return m_marks.concurrentTestAndSet(atomNumber(p));
+    }
+#endif
+
     inline void MarkedBlock::setMarked(const void* p)
     {
         m_marks.set(atomNumber(p));
     }
 
+#if ENABLE(GGC)
+    inline bool MarkedBlock::isNewlyAllocated(const void* p)
+    {
+        return m_newlyAllocated.get(atomNumber(p));
+    }
+
+    inline void MarkedBlock::setDirty()
+    {
+        m_dirty = 1;
+    }
+
+    inline bool MarkedBlock::isDirty()
+    {
+        return m_dirty;
+    }
+
+    inline void* MarkedBlock::addressOfDirty()
+    {
+        return &m_dirty;
+    }
+
+    inline ptrdiff_t MarkedBlock::offsetOfDirty()
+    {
+        return OBJECT_OFFSETOF(MarkedBlock, m_dirty);
+    }
+
+    inline void MarkedBlock::clearYoungMarks()
+    {
+        // Allocation marks cells; a minor collection has to find young cells again.
+        m_marks.exclude(m_newlyAllocated);
+    }
+
+    inline void MarkedBlock::resetGenerations()
+    {
+        m_newlyAllocated.clearAll();
+        m_dirty = 0;
+    }
+#endif
+
     template <typename Functor> inline void MarkedBlock::forEach(Functor& functor)
     {
         for (size_t i = firstAtom(); i < m_endAtom; i += m_atomsPerCell) {
@@ -21,11 +21,13 @@
 #include "config.h"
 #include "MarkedSpace.h"
 
+#include "GCActivityCallback.h"
 #include "JSCell.h"
 #include "JSGlobalData.h"
 #include "JSLock.h"
 #include "JSObject.h"
 #include "ScopeChain.h"
+#include <wtf/CurrentTime.h>
 
 namespace JSC {
 
@@ -45,6 +47,7 @@ MarkedSpace::MarkedSpace(JSGlobalData* globalData)
 
 void MarkedSpace::destroy()
 {
+    m_blocksToSweep.clear();
     clearMarks();
     shrink();
     ASSERT(!size());
@@ -57,6 +60,8 @@ MarkedBlock* MarkedSpace::allocateBlock(SizeClass& sizeClass)
     sizeClass.nextBlock = block;
     m_blocks.add(block);
 
+    globalData()->heap.activityCallback()->didAllocate(m_waterMark);
+
     return block;
 }
 
@@ -114,13 +119,55 @@ void MarkedSpace::clearMarks()
         (*it)->clearMarks();
 }
 
+#if ENABLE(GGC)
+void MarkedSpace::clearYoungMarks()
+{
+    BlockIterator end = m_blocks.end();
+    for (BlockIterator it = m_blocks.begin(); it != end; ++it)
+        (*it)->clearYoungMarks();
+}
+#endif
+
 void MarkedSpace::sweep()
 {
+    m_blocksToSweep.clear();
+
     BlockIterator end = m_blocks.end();
     for (BlockIterator it = m_blocks.begin(); it != end; ++it)
         (*it)->sweep();
 }
 
+void MarkedSpace::prepareIncrementalSweep()
+{
+    m_blocksToSweep.clear();
+    m_blocksToSweep.reserveCapacity(m_blocks.size());
+
+    BlockIterator end = m_blocks.end();
+    for (BlockIterator it = m_blocks.begin(); it != end; ++it)
+        m_blocksToSweep.append(*it);
+}
+
+bool MarkedSpace::sweepIncrementally(double deadline)
+{
+    // Checking the time is not free: do it every few blocks only.
+    static const size_t blocksPerTimeCheck = 16;
+
+    size_t swept = 0;
+    while (!m_blocksToSweep.isEmpty()) {
+        MarkedBlock* block = m_blocksToSweep.last();
+        m_blocksToSweep.removeLast();
+
+        // The block may have been freed by shrink() in the meantime.
+        if (m_blocks.contains(block))
+            block->sweep();
+
+        if (!(++swept % blocksPerTimeCheck) && currentTime() >= deadline)
+            break;
+    }
+
+    return m_blocksToSweep.isEmpty();
+}
+
 size_t MarkedSpace::objectCount() const
 {
     size_t result = 0;
@@ -150,6 +197,9 @@ size_t MarkedSpace::capacity() const
 
 void MarkedSpace::reset()
 {
+    // The new marks supersede any pending incremental sweep: dead cells left unswept
+    // are either reused by allocation or swept after the next collection.
+    m_blocksToSweep.clear();
     m_waterMark = 0;
 
     for (size_t cellSize = preciseStep; cellSize < preciseCutoff; cellSize += preciseStep)
@@ -159,8 +209,13 @@ void MarkedSpace::reset()
         sizeClassFor(cellSize).reset();
 
     BlockIterator end = m_blocks.end();
-    for (BlockIterator it = m_blocks.begin(); it != end; ++it)
+    for (BlockIterator it = m_blocks.begin(); it != end; ++it) {
         (*it)->reset();
+#if ENABLE(GGC)
+        // Whatever survived this collection is old from now on.
+        (*it)->resetGenerations();
+#endif
+    }
 }
 
 } // namespace JSC
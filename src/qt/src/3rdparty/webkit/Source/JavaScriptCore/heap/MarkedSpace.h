@@ -54,6 +54,9 @@ namespace JSC {
 
         static bool isMarked(const JSCell*);
         static bool testAndSetMarked(const JSCell*);
+#if ENABLE(PARALLEL_GC)
+        static bool concurrentTestAndSetMarked(const JSCell*);
+#endif
         static void setMarked(const JSCell*);
 
         MarkedSpace(JSGlobalData*);
@@ -67,14 +70,24 @@ namespace JSC {
         void* allocate(size_t);
 
         void clearMarks();
+#if ENABLE(GGC)
+        void clearYoungMarks();
+        template<typename Functor> void forEachCellInDirtyBlocks(Functor&);
+#endif
         void markRoots();
         void reset();
         void sweep();
         void shrink();
 
+        // Incremental sweeping: sweepIncrementally() sweeps the blocks recorded by
+        // prepareIncrementalSweep() until the deadline, and returns true once all are swept.
+        void prepareIncrementalSweep();
+        bool sweepIncrementally(double deadline);
+
         size_t size() const;
         size_t capacity() const;
         size_t objectCount() const;
+        size_t blockCount() const { return m_blocks.size(); }
 
         bool contains(const void*);
 
@@ -113,6 +126,7 @@ namespace JSC {
         SizeClass m_preciseSizeClasses[preciseCount];
         SizeClass m_impreciseSizeClasses[impreciseCount];
         HashSet<MarkedBlock*> m_blocks;
+        Vector<MarkedBlock*> m_blocksToSweep;
         size_t m_waterMark;
         size_t m_highWaterMark;
         JSGlobalData* m_globalData;
@@ -133,6 +147,13 @@ namespace JSC {
         return MarkedBlock::blockFor(cell)->testAndSetMarked(cell);
     }
 
+#if ENABLE(PARALLEL_GC)
+    inline bool MarkedSpace::concurrentTestAndSetMarked(const JSCell* cell)
+    {
+        return MarkedBlock::blockFor(cell)->concurrentTestAndSetMarked(cell);
+    }
+#endif
+
     inline void MarkedSpace::setMarked(const JSCell* cell)
     {
         MarkedBlock::blockFor(cell)->setMarked(cell);
@@ -157,6 +178,17 @@ namespace JSC {
             (*it)->forEach(functor);
     }
 
+#if ENABLE(GGC)
+    template <typename Functor> inline void MarkedSpace::forEachCellInDirtyBlocks(Functor& functor)
+    {
+        BlockIterator end = m_blocks.end();
+        for (BlockIterator it = m_blocks.begin(); it != end; ++it) {
+            if ((*it)->isDirty())
+                (*it)->forEach(functor);
+        }
+    }
+#endif
+
     inline JSGlobalData* MarkedSpace::globalData()
     {
         return m_globalData;
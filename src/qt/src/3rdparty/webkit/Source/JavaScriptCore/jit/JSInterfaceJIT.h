@@ -30,6 +30,7 @@
 #include "JITStubs.h"
 #include "JSValue.h"
 #include "MacroAssembler.h"
+#include "MarkedBlock.h"
 #include "RegisterFile.h"
 #include <wtf/AlwaysInline.h>
 #include <wtf/Vector.h>
@@ -193,8 +194,33 @@ namespace JSC {
         inline Jump emitLoadInt32(unsigned virtualRegisterIndex, RegisterID dst);
         inline Jump emitLoadDouble(unsigned virtualRegisterIndex, FPRegisterID dst, RegisterID scratch);
 
-        inline void storePtrWithWriteBarrier(TrustedImmPtr ptr, RegisterID /* owner */, Address dest)
+        // Write barriers for stores of cells into the cell in owner: they dirty the
+        // owner's MarkedBlock (see writeBarrier() in WriteBarrier.h). They are
+        // emitted unconditionally, as the code does not depend on the collector mode.
+        inline void emitWriteBarrier(RegisterID owner, RegisterID scratch)
         {
+#if ENABLE(GGC)
+            move(owner, scratch);
+            andPtr(TrustedImm32(static_cast<int32_t>(MarkedBlock::blockMask)), scratch);
+            store32(TrustedImm32(1), Address(scratch, MarkedBlock::offsetOfDirty()));
+#else
+            UNUSED_PARAM(owner);
+            UNUSED_PARAM(scratch);
+#endif
+        }
+
+        inline void emitWriteBarrier(JSCell* owner)
+        {
+#if ENABLE(GGC)
+            store32(TrustedImm32(1), MarkedBlock::blockFor(owner)->addressOfDirty());
+#else
+            UNUSED_PARAM(owner);
+#endif
+        }
+
+        inline void storePtrWithWriteBarrier(TrustedImmPtr ptr, RegisterID owner, Address dest, RegisterID scratch)
+        {
+            emitWriteBarrier(owner, scratch);
             storePtr(ptr, dest);
         }
 
@@ -26,6 +26,7 @@
 #include "config.h"
 #include "SourceProviderCache.h"
 
+#include "Identifier.h"
 #include "SourceProviderCacheItem.h"
 
 namespace JSC {
@@ -53,4 +54,128 @@ void SourceProviderCache::add(int sourcePosition, PassOwnPtr<SourceProviderCache
     m_contentByteSize += size;
 }
 
+static const uint32_t encodingVersion = 1;
+
+template <typename T> static void append(Vector<char>& buffer, T value)
+{
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+static void appendVariables(Vector<char>& buffer, const Vector<RefPtr<StringImpl> >& variables)
+{
+    append<uint32_t>(buffer, variables.size());
+    for (size_t i = 0; i < variables.size(); ++i) {
+        append<uint32_t>(buffer, variables[i]->length());
+        buffer.append(reinterpret_cast<const char*>(variables[i]->characters()), variables[i]->length() * sizeof(UChar));
+    }
+}
+
+void SourceProviderCache::encode(Vector<char>& buffer) const
+{
+    append<uint32_t>(buffer, encodingVersion);
+    append<uint32_t>(buffer, m_map.size());
+
+    HashMap<int, SourceProviderCacheItem*>::const_iterator end = m_map.end();
+    for (HashMap<int, SourceProviderCacheItem*>::const_iterator it = m_map.begin(); it != end; ++it) {
+        const SourceProviderCacheItem* item = it->second;
+        append<int32_t>(buffer, it->first);
+        append<int32_t>(buffer, item->closeBraceLine);
+        append<int32_t>(buffer, item->closeBracePos);
+        append<uint8_t>(buffer, item->usesEval);
+        appendVariables(buffer, item->usedVariables);
+        appendVariables(buffer, item->writtenVariables);
+    }
+}
+
+class CacheDecoder {
+public:
+    CacheDecoder(const char* data, size_t length)
+        : m_position(data)
+        , m_end(data + length)
+    {
+    }
+
+    template <typename T> bool read(T& value)
+    {
+        if (static_cast<size_t>(m_end - m_position) < sizeof(T))
+            return false;
+        memcpy(&value, m_position, sizeof(T));
+        m_position += sizeof(T);
+        return true;
+    }
+
+    bool readVariables(JSGlobalData* globalData, Vector<RefPtr<StringImpl> >& variables)
+    {
+        uint32_t count;
+        if (!read(count))
+            return false;
+        for (uint32_t i = 0; i < count; ++i) {
+            uint32_t length;
+            if (!read(length) || static_cast<size_t>(m_end - m_position) / sizeof(UChar) < length)
+                return false;
+            // The parser compares variables by identity: they have to be identifiers.
+            Vector<UChar> characters(length);
+            memcpy(characters.data(), m_position, length * sizeof(UChar));
+            m_position += length * sizeof(UChar);
+            variables.append(Identifier(globalData, UString(characters.data(), length)).impl());
+        }
+        return true;
+    }
+
+    bool atEnd() const { return m_position == m_end; }
+
+private:
+    const char* m_position;
+    const char* m_end;
+};
+
+bool SourceProviderCache::decode(JSGlobalData* globalData, const char* data, size_t length, const UChar* source, unsigned sourceLength)
+{
+    CacheDecoder decoder(data, length);
+    uint32_t version;
+    uint32_t count;
+    if (!decoder.read(version) || version != encodingVersion || !decoder.read(count))
+        return false;
+
+    Vector<std::pair<int, SourceProviderCacheItem*> > items;
+    bool succeeded = true;
+    for (uint32_t i = 0; i < count && succeeded; ++i) {
+        int32_t sourcePosition;
+        int32_t closeBraceLine;
+        int32_t closeBracePos;
+        uint8_t usesEval;
+        if (!decoder.read(sourcePosition) || !decoder.read(closeBraceLine) || !decoder.read(closeBracePos) || !decoder.read(usesEval)) {
+            succeeded = false;
+            break;
+        }
+        // The parser jumps straight to closeBracePos: it has to be the brace closing a function body.
+        if (sourcePosition < 0 || closeBracePos <= sourcePosition || static_cast<unsigned>(closeBracePos) >= sourceLength
+            || source[sourcePosition] != '{' || source[closeBracePos] != '}' || closeBraceLine <= 0) {
+            succeeded = false;
+            break;
+        }
+        OwnPtr<SourceProviderCacheItem> item = adoptPtr(new SourceProviderCacheItem(closeBraceLine, closeBracePos));
+        item->usesEval = usesEval;
+        succeeded = decoder.readVariables(globalData, item->usedVariables) && decoder.readVariables(globalData, item->writtenVariables);
+        items.append(std::make_pair(sourcePosition, item.leakPtr()));
+    }
+
+    if (!succeeded || !decoder.atEnd()) {
+        for (size_t i = 0; i < items.size(); ++i)
+            delete items[i].second;
+        return false;
+    }
+
+    for (size_t i = 0; i < items.size(); ++i) {
+        // An item already there was computed by this run's parser: keep it.
+        if (m_map.contains(items[i].first)) {
+            delete items[i].second;
+            continue;
+        }
+        unsigned approximateByteSize = items[i].second->approximateByteSize();
+        add(items[i].first, adoptPtr(items[i].second), approximateByteSize);
+    }
+    return true;
+}
+
 }
@@ -25,9 +25,12 @@
 
 #include <wtf/HashMap.h>
 #include <wtf/PassOwnPtr.h>
+#include <wtf/Vector.h>
+#include <wtf/unicode/Unicode.h>
 
 namespace JSC {
 
+class JSGlobalData;
 class SourceProviderCacheItem;
 
 class SourceProviderCache {
@@ -39,6 +42,13 @@ public:
     unsigned byteSize() const;
     void add(int sourcePosition, PassOwnPtr<SourceProviderCacheItem>, unsigned size);
     const SourceProviderCacheItem* get(int sourcePosition) const { return m_map.get(sourcePosition); }
+    bool isEmpty() const { return m_map.isEmpty(); }
+
+    // Flattens the cache, so that it can be kept across runs for the exact same source.
+    void encode(Vector<char>&) const;
+    // Adds the items of an encoded cache of source. Returns false, adding nothing, if the
+    // data is malformed or does not match the braces of source.
+    bool decode(JSGlobalData*, const char* data, size_t length, const UChar* source, unsigned sourceLength);
 
 private:
     HashMap<int, SourceProviderCacheItem*> m_map;
@@ -39,6 +39,7 @@
 #include "Profile.h"
 #include "ProfileGenerator.h"
 #include "ProfileNode.h"
+#include "SamplingProfiler.h"
 #include "UStringConcatenate.h"
 #include <stdio.h>
 
@@ -89,8 +90,7 @@ PassRefPtr<Profile> Profiler::stopProfiling(ExecState* exec, const UString& titl
             RefPtr<Profile> returnProfile = profileGenerator->profile();
 
             m_currentProfiles.remove(i);
-            if (!m_currentProfiles.size())
-                s_sharedEnabledProfilerReference = 0;
+            updateEnabledProfilerReference();
             
             return returnProfile;
         }
@@ -106,10 +106,41 @@ void Profiler::stopProfiling(JSGlobalObject* origin)
         if (profileGenerator->origin() == origin) {
             profileGenerator->stopProfiling();
             m_currentProfiles.remove(i);
-            if (!m_currentProfiles.size())
-                s_sharedEnabledProfilerReference = 0;
+            updateEnabledProfilerReference();
         }
     }
+    stopSampling(origin);
+}
+
+bool Profiler::startSampling(JSGlobalObject* origin, double interval)
+{
+    for (size_t i = 0; i < m_samplingProfilers.size(); ++i) {
+        if (m_samplingProfilers[i]->origin() == origin)
+            return false;
+    }
+
+    m_samplingProfilers.append(new SamplingProfiler(origin, interval));
+    updateEnabledProfilerReference();
+    return true;
+}
+
+PassOwnPtr<SamplingProfiler> Profiler::stopSampling(JSGlobalObject* origin)
+{
+    for (size_t i = 0; i < m_samplingProfilers.size(); ++i) {
+        if (m_samplingProfilers[i]->origin() == origin) {
+            OwnPtr<SamplingProfiler> samplingProfiler = adoptPtr(m_samplingProfilers[i]);
+            m_samplingProfilers.remove(i);
+            updateEnabledProfilerReference();
+            samplingProfiler->stop();
+            return samplingProfiler.release();
+        }
+    }
+    return nullptr;
+}
+
+void Profiler::updateEnabledProfilerReference()
+{
+    s_sharedEnabledProfilerReference = m_currentProfiles.isEmpty() && m_samplingProfilers.isEmpty() ? 0 : this;
 }
 
 static inline void dispatchFunctionToProfiles(ExecState* callerOrHandlerCallFrame, const Vector<RefPtr<ProfileGenerator> >& profiles, ProfileGenerator::ProfileFunction function, const CallIdentifier& callIdentifier, unsigned currentProfileTargetGroup)
@@ -120,16 +151,35 @@ static inline void dispatchFunctionToProfiles(ExecState* callerOrHandlerCallFram
     }
 }
 
+SamplingProfiler* Profiler::samplingProfilerFor(ExecState* exec) const
+{
+    for (size_t i = 0; i < m_samplingProfilers.size(); ++i) {
+        if (m_samplingProfilers[i]->origin() == exec->dynamicGlobalObject())
+            return m_samplingProfilers[i];
+    }
+    return 0;
+}
+
 void Profiler::willExecute(ExecState* callerCallFrame, JSValue function)
 {
-    ASSERT(!m_currentProfiles.isEmpty());
+    ASSERT(!m_currentProfiles.isEmpty() || !m_samplingProfilers.isEmpty());
+
+    if (SamplingProfiler* samplingProfiler = samplingProfilerFor(callerCallFrame))
+        samplingProfiler->willExecute(callerCallFrame, function, "", 0);
+    if (m_currentProfiles.isEmpty())
+        return;
 
     dispatchFunctionToProfiles(callerCallFrame, m_currentProfiles, &ProfileGenerator::willExecute, createCallIdentifier(callerCallFrame, function, "", 0), callerCallFrame->lexicalGlobalObject()->profileGroup());
 }
 
 void Profiler::willExecute(ExecState* callerCallFrame, const UString& sourceURL, int startingLineNumber)
 {
-    ASSERT(!m_currentProfiles.isEmpty());
+    ASSERT(!m_currentProfiles.isEmpty() || !m_samplingProfilers.isEmpty());
+
+    if (SamplingProfiler* samplingProfiler = samplingProfilerFor(callerCallFrame))
+        samplingProfiler->willExecute(callerCallFrame, JSValue(), sourceURL, startingLineNumber);
+    if (m_currentProfiles.isEmpty())
+        return;
 
     CallIdentifier callIdentifier = createCallIdentifier(callerCallFrame, JSValue(), sourceURL, startingLineNumber);
 
@@ -138,21 +188,36 @@ void Profiler::willExecute(ExecState* callerCallFrame, const UString& sourceURL,
 
 void Profiler::didExecute(ExecState* callerCallFrame, JSValue function)
 {
-    ASSERT(!m_currentProfiles.isEmpty());
+    ASSERT(!m_currentProfiles.isEmpty() || !m_samplingProfilers.isEmpty());
+
+    if (SamplingProfiler* samplingProfiler = samplingProfilerFor(callerCallFrame))
+        samplingProfiler->didExecute(callerCallFrame);
+    if (m_currentProfiles.isEmpty())
+        return;
 
     dispatchFunctionToProfiles(callerCallFrame, m_currentProfiles, &ProfileGenerator::didExecute, createCallIdentifier(callerCallFrame, function, "", 0), callerCallFrame->lexicalGlobalObject()->profileGroup());
 }
 
 void Profiler::didExecute(ExecState* callerCallFrame, const UString& sourceURL, int startingLineNumber)
 {
-    ASSERT(!m_currentProfiles.isEmpty());
+    ASSERT(!m_currentProfiles.isEmpty() || !m_samplingProfilers.isEmpty());
+
+    if (SamplingProfiler* samplingProfiler = samplingProfilerFor(callerCallFrame))
+        samplingProfiler->didExecute(callerCallFrame);
+    if (m_currentProfiles.isEmpty())
+        return;
 
     dispatchFunctionToProfiles(callerCallFrame, m_currentProfiles, &ProfileGenerator::didExecute, createCallIdentifier(callerCallFrame, JSValue(), sourceURL, startingLineNumber), callerCallFrame->lexicalGlobalObject()->profileGroup());
 }
 
 void Profiler::exceptionUnwind(ExecState* handlerCallFrame)
 {
-    ASSERT(!m_currentProfiles.isEmpty());
+    ASSERT(!m_currentProfiles.isEmpty() || !m_samplingProfilers.isEmpty());
+
+    if (SamplingProfiler* samplingProfiler = samplingProfilerFor(handlerCallFrame))
+        samplingProfiler->exceptionUnwind(handlerCallFrame);
+    if (m_currentProfiles.isEmpty())
+        return;
 
     dispatchFunctionToProfiles(handlerCallFrame, m_currentProfiles, &ProfileGenerator::exceptionUnwind, createCallIdentifier(handlerCallFrame, JSValue(), "", 0), handlerCallFrame->lexicalGlobalObject()->profileGroup());
 }
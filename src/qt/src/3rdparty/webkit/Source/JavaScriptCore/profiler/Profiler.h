@@ -30,6 +30,7 @@
 #define Profiler_h
 
 #include "Profile.h"
+#include <wtf/PassOwnPtr.h>
 #include <wtf/PassRefPtr.h>
 #include <wtf/RefPtr.h>
 #include <wtf/Vector.h>
@@ -42,6 +43,7 @@ namespace JSC {
     class JSObject;
     class JSValue;
     class ProfileGenerator;
+    class SamplingProfiler;
     class UString;
     struct CallIdentifier;    
 
@@ -60,6 +62,11 @@ namespace JSC {
         PassRefPtr<Profile> stopProfiling(ExecState*, const UString& title);
         void stopProfiling(JSGlobalObject*);
 
+        // Samples the code run on behalf of origin every interval seconds, see SamplingProfiler.
+        bool startSampling(JSGlobalObject* origin, double interval);
+        PassOwnPtr<SamplingProfiler> stopSampling(JSGlobalObject* origin);
+        bool isSampling() const { return !m_samplingProfilers.isEmpty(); }
+
         void willExecute(ExecState* callerCallFrame, JSValue function);
         void willExecute(ExecState* callerCallFrame, const UString& sourceURL, int startingLineNumber);
         void didExecute(ExecState* callerCallFrame, JSValue function);
@@ -70,7 +77,11 @@ namespace JSC {
         const Vector<RefPtr<ProfileGenerator> >& currentProfiles() { return m_currentProfiles; };
 
     private:
+        void updateEnabledProfilerReference();
+        SamplingProfiler* samplingProfilerFor(ExecState*) const;
+
         Vector<RefPtr<ProfileGenerator> > m_currentProfiles;
+        Vector<SamplingProfiler*> m_samplingProfilers;
         static Profiler* s_sharedProfiler;
         static Profiler* s_sharedEnabledProfilerReference;
     };
@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2013 The PhantomJS project. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "SamplingProfiler.h"
+
+#include "CallFrame.h"
+#include "JSGlobalObject.h"
+#include "Profiler.h"
+#include <wtf/CurrentTime.h>
+
+namespace JSC {
+
+SamplingProfiler::SamplingProfiler(JSGlobalObject* origin, double interval)
+    : m_origin(origin)
+    , m_interval(interval)
+    , m_startTime(currentTime())
+    , m_endTime(0)
+    , m_resolvedDepth(0)
+    , m_tickCount(0)
+    , m_takenTickCount(0)
+    , m_stopped(false)
+{
+    // Function 0 stands for the root, so that no (parent, function) key is empty.
+    m_functions.append(CallIdentifier("(root)", "", 0));
+    m_nodes.append(Node(0, rootNode));
+
+    m_tickThread = createThread(tickThreadStartFunc, this, "JavaScriptCore::SamplingProfiler");
+}
+
+SamplingProfiler::~SamplingProfiler()
+{
+    stop();
+}
+
+void* SamplingProfiler::tickThreadStartFunc(void* profiler)
+{
+    static_cast<SamplingProfiler*>(profiler)->tickThreadMain();
+    return 0;
+}
+
+void SamplingProfiler::tickThreadMain()
+{
+    MutexLocker locker(m_tickLock);
+    double nextTick = currentTime() + m_interval;
+    while (!m_stopped) {
+        if (m_tickCondition.timedWait(m_tickLock, nextTick) || currentTime() < nextTick)
+            continue;
+        ++m_tickCount;
+        nextTick += m_interval;
+    }
+}
+
+void SamplingProfiler::stop()
+{
+    if (!m_tickThread)
+        return;
+    {
+        MutexLocker locker(m_tickLock);
+        m_stopped = true;
+        m_tickCondition.signal();
+    }
+    waitForThreadCompletion(m_tickThread, 0);
+    m_tickThread = 0;
+    m_endTime = currentTime();
+}
+
+void SamplingProfiler::willExecute(ExecState* callerCallFrame, JSValue function, const UString& sourceURL, int lineNumber)
+{
+    // The time since the last sample was spent in the caller, or outside of JavaScript.
+    if (hasPendingTicks())
+        takeSample();
+
+    Frame frame;
+    frame.callerCallFrame = callerCallFrame;
+    frame.function = function;
+    frame.sourceURL = sourceURL;
+    frame.lineNumber = lineNumber;
+    m_stack.append(frame);
+}
+
+void SamplingProfiler::didExecute(ExecState*)
+{
+    if (m_stack.isEmpty())
+        return;
+    if (hasPendingTicks())
+        takeSample();
+
+    m_stack.removeLast();
+    if (m_resolvedDepth > m_stack.size())
+        m_resolvedDepth = m_stack.size();
+}
+
+void SamplingProfiler::exceptionUnwind(ExecState* handlerCallFrame)
+{
+    if (hasPendingTicks())
+        takeSample();
+
+    // Drop the frames the exception went through, down to the function handling it.
+    JSValue handler = handlerCallFrame->callee();
+    while (!m_stack.isEmpty() && m_stack.last().function != handler)
+        m_stack.removeLast();
+    if (m_resolvedDepth > m_stack.size())
+        m_resolvedDepth = m_stack.size();
+}
+
+void SamplingProfiler::takeSample()
+{
+    unsigned tickCount = m_tickCount;
+    unsigned ticks = tickCount - m_takenTickCount;
+    m_takenTickCount = tickCount;
+    // Ticks that went by with nothing on the stack were spent outside of JavaScript.
+    if (m_stack.isEmpty())
+        return;
+
+    m_stackNodes.resize(m_stack.size());
+    for (size_t i = m_resolvedDepth; i < m_stack.size(); ++i)
+        m_stackNodes[i] = nodeForFrame(i ? m_stackNodes[i - 1] : rootNode, m_stack[i]);
+    m_resolvedDepth = m_stack.size();
+
+    unsigned node = m_stackNodes.last();
+    m_nodes[node].hitCount += ticks;
+    double now = currentTime();
+    for (unsigned i = 0; i < ticks; ++i) {
+        m_samples.append(node);
+        m_sampleTimes.append(now);
+    }
+}
+
+unsigned SamplingProfiler::nodeForFrame(unsigned parent, const Frame& frame)
+{
+    CallIdentifier callIdentifier = Profiler::createCallIdentifier(frame.callerCallFrame, frame.function, frame.sourceURL, frame.lineNumber);
+    pair<HashMap<CallIdentifier, unsigned>::iterator, bool> function = m_functionIndices.add(callIdentifier, m_functions.size());
+    if (function.second)
+        m_functions.append(callIdentifier);
+
+    pair<HashMap<std::pair<unsigned, unsigned>, unsigned>::iterator, bool> child = m_childIndices.add(std::make_pair(parent, function.first->second), m_nodes.size());
+    if (child.second) {
+        m_nodes.append(Node(function.first->second, parent));
+        m_nodes[parent].children.append(child.first->second);
+    }
+    return child.first->second;
+}
+
+} // namespace JSC
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2013 The PhantomJS project. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SamplingProfiler_h
+#define SamplingProfiler_h
+
+#include "CallIdentifier.h"
+#include "JSValue.h"
+#include <wtf/HashMap.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/Threading.h>
+#include <wtf/Vector.h>
+
+namespace JSC {
+
+    class ExecState;
+    class JSGlobalObject;
+
+    // Statistical profiler for the code run on behalf of one global object.
+    //
+    // A thread ticks at the sampling interval. The Profiler hooks keep a shadow
+    // stack of the functions being run, and each pending tick is charged to the
+    // top of that stack the next time a function is entered or left. Only the
+    // hooks compiled into code while sampling is on report calls between
+    // JavaScript functions, so code compiled before has to be recompiled.
+    class SamplingProfiler {
+        WTF_MAKE_NONCOPYABLE(SamplingProfiler); WTF_MAKE_FAST_ALLOCATED;
+    public:
+        struct Node {
+            Node(unsigned function, unsigned parent)
+                : function(function)
+                , parent(parent)
+                , hitCount(0)
+            {
+            }
+
+            unsigned function;
+            unsigned parent;
+            unsigned hitCount;
+            Vector<unsigned> children;
+        };
+
+        static const unsigned rootNode = 0;
+
+        SamplingProfiler(JSGlobalObject* origin, double interval);
+        ~SamplingProfiler();
+
+        JSGlobalObject* origin() const { return m_origin; }
+
+        void willExecute(ExecState* callerCallFrame, JSValue function, const UString& sourceURL, int lineNumber);
+        void didExecute(ExecState* callerCallFrame);
+        void exceptionUnwind(ExecState* handlerCallFrame);
+
+        // Stops the ticking thread: the results below are final afterwards.
+        void stop();
+
+        // Node 0 is the root; every other node is a call path, identified by the
+        // last function on it.
+        const Vector<Node>& nodes() const { return m_nodes; }
+        const Vector<CallIdentifier>& functions() const { return m_functions; }
+        // The node charged with each sample, and when the sample was taken.
+        const Vector<unsigned>& samples() const { return m_samples; }
+        const Vector<double>& sampleTimes() const { return m_sampleTimes; }
+        double startTime() const { return m_startTime; }
+        double endTime() const { return m_endTime; }
+
+    private:
+        struct Frame {
+            ExecState* callerCallFrame;
+            JSValue function;
+            UString sourceURL;
+            int lineNumber;
+        };
+
+        static void* tickThreadStartFunc(void*);
+        void tickThreadMain();
+
+        bool hasPendingTicks() const { return m_tickCount != m_takenTickCount; }
+        void takeSample();
+        unsigned nodeForFrame(unsigned parent, const Frame&);
+
+        JSGlobalObject* m_origin;
+        double m_interval;
+        double m_startTime;
+        double m_endTime;
+
+        Vector<Frame, 64> m_stack;
+        // The nodes of the first m_resolvedDepth frames of m_stack.
+        Vector<unsigned, 64> m_stackNodes;
+        size_t m_resolvedDepth;
+
+        Vector<Node> m_nodes;
+        Vector<CallIdentifier> m_functions;
+        HashMap<CallIdentifier, unsigned> m_functionIndices;
+        HashMap<std::pair<unsigned, unsigned>, unsigned> m_childIndices;
+        Vector<unsigned> m_samples;
+        Vector<double> m_sampleTimes;
+
+        // Written by the ticking thread alone.
+        volatile unsigned m_tickCount;
+        unsigned m_takenTickCount;
+
+        Mutex m_tickLock;
+        ThreadCondition m_tickCondition;
+        bool m_stopped;
+        ThreadIdentifier m_tickThread;
+    };
+
+} // namespace JSC
+
+#endif // SamplingProfiler_h
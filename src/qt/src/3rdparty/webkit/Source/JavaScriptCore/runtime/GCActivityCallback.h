@@ -43,7 +43,10 @@ class Heap;
 class GCActivityCallback {
 public:
     virtual ~GCActivityCallback() {}
+    // Called after each collection.
     virtual void operator()() {}
+    // Called whenever the heap takes a new block.
+    virtual void didAllocate(size_t /* bytesSinceLastCollection */) {}
     virtual void synchronize() {}
 
 protected:
@@ -60,6 +63,9 @@ public:
     ~DefaultGCActivityCallback();
 
     void operator()();
+#if PLATFORM(QT)
+    void didAllocate(size_t bytesSinceLastCollection);
+#endif
     void synchronize();
 
 #if USE(CF)
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2013 The PhantomJS project. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "GCActivityCallback.h"
+
+#include "APIShims.h"
+#include "Heap.h"
+#include "JSGlobalData.h"
+#include <QBasicTimer>
+#include <QObject>
+#include <QThread>
+#include <QTimerEvent>
+
+#if !PLATFORM(QT)
+#error "This file should only be used on the Qt port."
+#endif
+
+namespace JSC {
+
+// Without this, collections only happen when allocation reaches the heap's
+// high water mark, which is usually in the middle of running a script. Once
+// enough has been allocated since the last collection, we collect as soon as
+// the event loop has had nothing for JavaScript to do for triggerInterval.
+const size_t minBytesForIdleCollection = 1024 * 1024;
+const int triggerInterval = 500; // milliseconds
+// Only marking stops the world: dead cells are then swept in slices this long, between other events.
+const double sweepSliceTime = 0.005; // seconds
+
+struct DefaultGCActivityCallbackPlatformData : public QObject {
+    DefaultGCActivityCallbackPlatformData(Heap* heap)
+        : heap(heap)
+    {
+    }
+
+    void timerEvent(QTimerEvent*);
+
+    Heap* heap;
+    QBasicTimer timer;
+    QBasicTimer sweepTimer;
+};
+
+void DefaultGCActivityCallbackPlatformData::timerEvent(QTimerEvent* event)
+{
+    if (event->timerId() == sweepTimer.timerId()) {
+        if (!heap->globalData()) {
+            sweepTimer.stop();
+            return;
+        }
+        APIEntryShim shim(heap->globalData());
+        if (!heap->isBusy() && heap->sweepIncrementally(sweepSliceTime))
+            sweepTimer.stop();
+        return;
+    }
+
+    if (event->timerId() != timer.timerId()) {
+        QObject::timerEvent(event);
+        return;
+    }
+
+    timer.stop();
+    if (heap->isBusy() || !heap->globalData())
+        return;
+
+    APIEntryShim shim(heap->globalData());
+    heap->collectAllGarbageIncrementally();
+    sweepTimer.start(0, this);
+}
+
+DefaultGCActivityCallback::DefaultGCActivityCallback(Heap* heap)
+    : d(adoptPtr(new DefaultGCActivityCallbackPlatformData(heap)))
+{
+}
+
+DefaultGCActivityCallback::~DefaultGCActivityCallback()
+{
+    d->timer.stop();
+    d->sweepTimer.stop();
+}
+
+void DefaultGCActivityCallback::operator()()
+{
+    // A collection just happened.
+    d->timer.stop();
+}
+
+void DefaultGCActivityCallback::didAllocate(size_t bytesSinceLastCollection)
+{
+    if (bytesSinceLastCollection < minBytesForIdleCollection)
+        return;
+
+    // Restarting pushes the collection back until allocation stops.
+    d->timer.start(triggerInterval, d.get());
+}
+
+void DefaultGCActivityCallback::synchronize()
+{
+    if (d->thread() == QThread::currentThread())
+        return;
+    d->timer.stop();
+    d->sweepTimer.stop();
+    d->moveToThread(QThread::currentThread());
+}
+
+}
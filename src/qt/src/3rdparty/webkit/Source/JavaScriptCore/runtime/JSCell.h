@@ -351,6 +351,9 @@ namespace JSC {
     {
         while (m_nextAtom < m_endAtom) {
             if (!m_marks.testAndSet(m_nextAtom)) {
+#if ENABLE(GGC)
+                m_newlyAllocated.set(m_nextAtom);
+#endif
                 JSCell* cell = reinterpret_cast<JSCell*>(&atoms()[m_nextAtom]);
                 m_nextAtom += m_atomsPerCell;
                 cell->~JSCell();
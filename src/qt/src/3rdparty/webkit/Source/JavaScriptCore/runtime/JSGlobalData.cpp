@@ -238,6 +238,18 @@ JSGlobalData::JSGlobalData(GlobalDataType globalDataType, ThreadStackType thread
 #endif
     jitStubs = adoptPtr(new JITThunks(this));
 #endif
+#if ENABLE(DFG_JIT)
+#if PLATFORM(MAC)
+    m_canUseDFGJIT = true;
+#else
+    // Still being validated outside of the Mac: the DFG JIT has to be asked for.
+    char* canUseDFGJITString = getenv("JavaScriptCoreUseDFGJIT");
+    m_canUseDFGJIT = canUseDFGJITString && atoi(canUseDFGJITString);
+#endif
+    // The DFG JIT does not emit the write barriers generational collection needs.
+    if (heap.isGenerational())
+        m_canUseDFGJIT = false;
+#endif
 }
 
 void JSGlobalData::clearBuiltinStructures()
@@ -197,6 +197,10 @@ namespace JSC {
         bool canUseJIT() { return m_canUseJIT; }
 #endif
 
+#if ENABLE(DFG_JIT)
+        bool canUseDFGJIT() { return m_canUseDFGJIT; }
+#endif
+
         const StackBounds& stack()
         {
             return (globalDataType == Default)
@@ -276,6 +280,9 @@ namespace JSC {
         void createNativeThunk();
 #if ENABLE(JIT) && ENABLE(INTERPRETER)
         bool m_canUseJIT;
+#endif
+#if ENABLE(DFG_JIT)
+        bool m_canUseDFGJIT;
 #endif
         StackBounds m_stack;
     };
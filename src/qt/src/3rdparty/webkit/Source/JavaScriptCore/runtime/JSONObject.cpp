@@ -26,6 +26,7 @@
 #include "config.h"
 #include "JSONObject.h"
 
+#include "ArrayPrototype.h"
 #include "BooleanObject.h"
 #include "Error.h"
 #include "ExceptionHelpers.h"
@@ -38,7 +39,9 @@
 #include "PropertyNameArray.h"
 #include "UStringBuilder.h"
 #include "UStringConcatenate.h"
+#include <wtf/HashMap.h>
 #include <wtf/MathExtras.h>
+#include <wtf/RefCounted.h>
 
 namespace JSC {
 
@@ -87,6 +90,14 @@ public:
     void visitAggregate(SlotVisitor&);
 
 private:
+    // The enumerable properties of objects of a given plain structure, and where each is stored.
+    struct StructureProperties : RefCounted<StructureProperties> {
+        static PassRefPtr<StructureProperties> create() { return adoptRef(new StructureProperties); }
+
+        RefPtr<PropertyNameArrayData> names;
+        Vector<size_t> offsets;
+    };
+
     class Holder {
     public:
         Holder(JSGlobalData&, JSObject*);
@@ -102,6 +113,8 @@ private:
         unsigned m_index;
         unsigned m_size;
         RefPtr<PropertyNameArrayData> m_propertyNames;
+        RefPtr<StructureProperties> m_structureProperties;
+        Structure* m_structure;
     };
 
     friend class Holder;
@@ -109,6 +122,9 @@ private:
     static void appendQuotedString(UStringBuilder&, const UString&);
 
     JSValue toJSON(JSValue, const PropertyNameForFunctionCall&);
+    bool isKnownToLackToJSON(JSObject*) const;
+    void rememberLacksToJSON(JSObject*);
+    PassRefPtr<StructureProperties> structureProperties(JSObject*);
 
     enum StringifyResult { StringifyFailed, StringifySucceeded, StringifyFailedDueToUndefinedValue };
     StringifyResult appendStringifiedValue(UStringBuilder&, JSValue, JSObject* holder, const PropertyNameForFunctionCall&);
@@ -129,6 +145,13 @@ private:
     Vector<Holder, 16> m_holderStack;
     UString m_repeatedGap;
     UString m_indent;
+
+    // Maps the structures of objects found to have no toJSON to those of their prototypes
+    // at the time: the answer stands for as long as none of them changed.
+    HashMap<Structure*, Vector<Structure*> > m_structuresWithoutToJSON;
+    HashMap<Structure*, RefPtr<StructureProperties> > m_propertiesForStructures;
+    // Keeps the structures used as keys above from being collected and their cells reused.
+    Vector<Strong<Structure> > m_cachedStructures;
 };
 
 // ------------------------------ helper functions --------------------------------
@@ -147,6 +170,32 @@ static inline JSValue unwrapBoxedPrimitive(ExecState* exec, JSValue value)
     return value;
 }
 
+static inline void appendInteger(UStringBuilder& builder, int32_t value)
+{
+    char buffer[12];
+    char* end = buffer + sizeof(buffer);
+    char* position = end;
+    uint32_t magnitude = value < 0 ? -static_cast<uint32_t>(value) : value;
+    do {
+        *--position = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude);
+    if (value < 0)
+        *--position = '-';
+    builder.append(position, end - position);
+}
+
+// Whether a lookup of toJSON on the object only depends on its structure.
+static inline bool hasStructureDeterminedToJSON(JSObject* object)
+{
+    if (object->structure()->isDictionary())
+        return false;
+    const ClassInfo* classInfo = object->classInfo();
+    if (classInfo == &JSObject::s_info)
+        return !object->structure()->typeInfo().overridesGetOwnPropertySlot();
+    return classInfo == &JSArray::s_info || classInfo == &ArrayPrototype::s_info;
+}
+
 static inline UString gap(ExecState* exec, JSValue space)
 {
     const unsigned maxGapLength = 10;
@@ -291,19 +340,18 @@ Local<Unknown> Stringifier::stringify(Handle<Unknown> value)
 
 void Stringifier::appendQuotedString(UStringBuilder& builder, const UString& value)
 {
-    int length = value.length();
+    const UChar* position = value.characters();
+    const UChar* end = position + value.length();
 
     builder.append('"');
 
-    const UChar* data = value.characters();
-    for (int i = 0; i < length; ++i) {
-        int start = i;
-        while (i < length && (data[i] > 0x1F && data[i] != '"' && data[i] != '\\'))
-            ++i;
-        builder.append(data + start, i - start);
-        if (i >= length)
+    for (; position < end; ++position) {
+        const UChar* start = position;
+        position = findJSONSpecialCharacter(position, end);
+        builder.append(start, position - start);
+        if (position >= end)
             break;
-        switch (data[i]) {
+        switch (*position) {
             case '\t':
                 builder.append('\\');
                 builder.append('t');
@@ -334,7 +382,7 @@ void Stringifier::appendQuotedString(UStringBuilder& builder, const UString& val
                 break;
             default:
                 static const char hexDigits[] = "0123456789abcdef";
-                UChar ch = data[i];
+                UChar ch = *position;
                 UChar hex[] = { '\\', 'u', hexDigits[(ch >> 12) & 0xF], hexDigits[(ch >> 8) & 0xF], hexDigits[(ch >> 4) & 0xF], hexDigits[ch & 0xF] };
                 builder.append(hex, WTF_ARRAY_LENGTH(hex));
                 break;
@@ -347,8 +395,12 @@ void Stringifier::appendQuotedString(UStringBuilder& builder, const UString& val
 inline JSValue Stringifier::toJSON(JSValue value, const PropertyNameForFunctionCall& propertyName)
 {
     ASSERT(!m_exec->hadException());
-    if (!value.isObject() || !asObject(value)->hasProperty(m_exec, m_exec->globalData().propertyNames->toJSON))
+    if (!value.isObject() || isKnownToLackToJSON(asObject(value)))
+        return value;
+    if (!asObject(value)->hasProperty(m_exec, m_exec->globalData().propertyNames->toJSON)) {
+        rememberLacksToJSON(asObject(value));
         return value;
+    }
 
     JSValue toJSONFunction = asObject(value)->get(m_exec, m_exec->globalData().propertyNames->toJSON);
     if (m_exec->hadException())
@@ -368,6 +420,69 @@ inline JSValue Stringifier::toJSON(JSValue value, const PropertyNameForFunctionC
     return call(m_exec, object, callType, callData, value, args);
 }
 
+bool Stringifier::isKnownToLackToJSON(JSObject* object) const
+{
+    HashMap<Structure*, Vector<Structure*> >::const_iterator it = m_structuresWithoutToJSON.find(object->structure());
+    if (it == m_structuresWithoutToJSON.end())
+        return false;
+    const Vector<Structure*>& prototypeStructures = it->second;
+    JSValue prototype = object->prototype();
+    for (size_t i = 0; i < prototypeStructures.size(); ++i) {
+        if (asObject(prototype)->structure() != prototypeStructures[i])
+            return false;
+        prototype = prototypeStructures[i]->storedPrototype();
+    }
+    return true;
+}
+
+void Stringifier::rememberLacksToJSON(JSObject* object)
+{
+    if (!hasStructureDeterminedToJSON(object))
+        return;
+    Vector<Structure*> prototypeStructures;
+    for (JSValue prototype = object->prototype(); !prototype.isNull(); prototype = asObject(prototype)->prototype()) {
+        if (!prototype.isObject() || !hasStructureDeterminedToJSON(asObject(prototype)))
+            return;
+        prototypeStructures.append(asObject(prototype)->structure());
+    }
+
+    JSGlobalData& globalData = m_exec->globalData();
+    m_cachedStructures.append(Strong<Structure>(globalData, object->structure()));
+    for (size_t i = 0; i < prototypeStructures.size(); ++i)
+        m_cachedStructures.append(Strong<Structure>(globalData, prototypeStructures[i]));
+    m_structuresWithoutToJSON.set(object->structure(), prototypeStructures);
+}
+
+// Returns 0 unless the properties of the object can be read straight from its storage.
+PassRefPtr<Stringifier::StructureProperties> Stringifier::structureProperties(JSObject* object)
+{
+    Structure* structure = object->structure();
+    if (object->classInfo() != &JSObject::s_info || structure->isDictionary() || structure->hasGetterSetterProperties()
+        || structure->typeInfo().overridesGetOwnPropertySlot() || structure->typeInfo().overridesGetPropertyNames())
+        return 0;
+
+    HashMap<Structure*, RefPtr<StructureProperties> >::iterator it = m_propertiesForStructures.find(structure);
+    if (it != m_propertiesForStructures.end())
+        return it->second;
+
+    PropertyNameArray propertyNames(m_exec);
+    object->getOwnPropertyNames(m_exec, propertyNames);
+    RefPtr<StructureProperties> properties = StructureProperties::create();
+    for (PropertyNameArray::const_iterator name = propertyNames.begin(); name != propertyNames.end(); ++name) {
+        unsigned attributes;
+        JSCell* specificValue;
+        size_t offset = structure->get(m_exec->globalData(), *name, attributes, specificValue);
+        if (offset == WTF::notFound)
+            return 0;
+        properties->offsets.append(offset);
+    }
+    properties->names = propertyNames.releaseData();
+
+    m_cachedStructures.append(Strong<Structure>(m_exec->globalData(), structure));
+    m_propertiesForStructures.set(structure, properties);
+    return properties.release();
+}
+
 Stringifier::StringifyResult Stringifier::appendStringifiedValue(UStringBuilder& builder, JSValue value, JSObject* holder, const PropertyNameForFunctionCall& propertyName)
 {
     // Call the toJSON function.
@@ -402,6 +517,11 @@ Stringifier::StringifyResult Stringifier::appendStringifiedValue(UStringBuilder&
         return StringifySucceeded;
     }
 
+    if (value.isInt32()) {
+        appendInteger(builder, value.asInt32());
+        return StringifySucceeded;
+    }
+
     UString stringValue;
     if (value.getString(m_exec, stringValue)) {
         appendQuotedString(builder, stringValue);
@@ -497,6 +617,7 @@ inline Stringifier::Holder::Holder(JSGlobalData& globalData, JSObject* object)
     : m_object(globalData, object)
     , m_isArray(object->inherits(&JSArray::s_info))
     , m_index(0)
+    , m_structure(0)
 {
 }
 
@@ -510,12 +631,18 @@ bool Stringifier::Holder::appendNextProperty(Stringifier& stringifier, UStringBu
     if (!m_index) {
         if (m_isArray) {
             m_isJSArray = isJSArray(&exec->globalData(), m_object.get());
-            m_size = m_object->get(exec, exec->globalData().propertyNames->length).toUInt32(exec);
+            if (m_isJSArray)
+                m_size = asArray(m_object.get())->length();
+            else
+                m_size = m_object->get(exec, exec->globalData().propertyNames->length).toUInt32(exec);
             builder.append('[');
         } else {
             if (stringifier.m_usingArrayReplacer)
                 m_propertyNames = stringifier.m_arrayReplacerPropertyNames.data();
-            else {
+            else if ((m_structureProperties = stringifier.structureProperties(m_object.get()))) {
+                m_structure = m_object->structure();
+                m_propertyNames = m_structureProperties->names;
+            } else {
                 PropertyNameArray objectPropertyNames(exec);
                 m_object->getOwnPropertyNames(exec, objectPropertyNames);
                 m_propertyNames = objectPropertyNames.releaseData();
@@ -561,14 +688,19 @@ bool Stringifier::Holder::appendNextProperty(Stringifier& stringifier, UStringBu
         // Append the stringified value.
         stringifyResult = stringifier.appendStringifiedValue(builder, value, m_object.get(), index);
     } else {
-        // Get the value.
-        PropertySlot slot(m_object.get());
+        // Get the value, straight from the object's storage if its structure is still the one it started with.
         Identifier& propertyName = m_propertyNames->propertyNameVector()[index];
-        if (!m_object->getOwnPropertySlot(exec, propertyName, slot))
-            return true;
-        JSValue value = slot.getValue(exec, propertyName);
-        if (exec->hadException())
-            return false;
+        JSValue value;
+        if (m_structureProperties && m_object->structure() == m_structure)
+            value = m_object->getDirectOffset(m_structureProperties->offsets[index]);
+        else {
+            PropertySlot slot(m_object.get());
+            if (!m_object->getOwnPropertySlot(exec, propertyName, slot))
+                return true;
+            value = slot.getValue(exec, propertyName);
+            if (exec->hadException())
+                return false;
+        }
 
         rollBackPoint = builder.length();
 
@@ -27,6 +27,7 @@
 #include "LiteralParser.h"
 
 #include "JSArray.h"
+#include "JSGlobalObject.h"
 #include "JSString.h"
 #include "Lexer.h"
 #include "UStringBuilder.h"
@@ -145,8 +146,19 @@ template <LiteralParser::ParserMode mode> inline LiteralParser::TokenType Litera
     UStringBuilder builder;
     do {
         runStart = m_ptr;
+        if (mode == StrictJSON)
+            m_ptr = findJSONSpecialCharacter(m_ptr, m_end);
+        // The scan stops at tabs, which the character loop then accepts.
         while (m_ptr < m_end && isSafeStringCharacter<mode>(*m_ptr))
             ++m_ptr;
+        if (!builder.length() && m_ptr < m_end && *m_ptr == '"') {
+            token.stringToken = UString();
+            token.stringStart = runStart;
+            token.stringLength = m_ptr - runStart;
+            token.type = TokString;
+            token.end = ++m_ptr;
+            return TokString;
+        }
         if (runStart < m_ptr)
             builder.append(runStart, m_ptr - runStart);
         if ((mode == StrictJSON) && m_ptr < m_end && *m_ptr == '\\') {
@@ -208,6 +220,7 @@ template <LiteralParser::ParserMode mode> inline LiteralParser::TokenType Litera
         return TokError;
 
     token.stringToken = builder.toUString();
+    token.stringStart = 0;
     token.type = TokString;
     token.end = ++m_ptr;
     return TokString;
@@ -287,10 +300,32 @@ LiteralParser::TokenType LiteralParser::Lexer::lexNumber(LiteralParserToken& tok
     return TokNumber;
 }
 
+JSValue LiteralParser::makeArray(Vector<JSValue, 16>& elements, MarkedArgumentBuffer& elementCells, Vector<size_t, 16>& arrayStarts)
+{
+    size_t start = arrayStarts.last();
+    arrayStarts.removeLast();
+    size_t count = elements.size() - start;
+    // The cells among the elements stay on the marked stack until the array holds them.
+    JSArray* array = constructArray(m_exec, ArgList(elements.data() + start, count));
+    for (size_t i = start; i < elements.size(); ++i) {
+        if (elements[i].isCell())
+            elementCells.removeLast();
+    }
+    elements.shrink(start);
+    return array;
+}
+
 JSValue LiteralParser::parse(ParserState initialState)
 {
     ParserState state = initialState;
     MarkedArgumentBuffer objectStack;
+    // The elements of the arrays being parsed, one after the other: each array is
+    // only created once complete, with storage of the right size. The cells among
+    // them are kept on a marked stack of their own: a MarkedArgumentBuffer is only
+    // marked once a cell has made it spill out of its inline buffer.
+    Vector<JSValue, 16> elementStack;
+    MarkedArgumentBuffer elementCellStack;
+    Vector<size_t, 16> arrayStartStack;
     JSValue lastValue;
     Vector<ParserState, 16> stateStack;
     Vector<Identifier, 16> identifierStack;
@@ -298,8 +333,7 @@ JSValue LiteralParser::parse(ParserState initialState)
         switch(state) {
             startParseArray:
             case StartParseArray: {
-                JSArray* array = constructEmptyArray(m_exec);
-                objectStack.append(array);
+                arrayStartStack.append(elementStack.size());
                 // fallthrough
             }
             doParseArrayStartExpression:
@@ -309,8 +343,7 @@ JSValue LiteralParser::parse(ParserState initialState)
                     if (lastToken == TokComma)
                         return JSValue();
                     m_lexer.next();
-                    lastValue = objectStack.last();
-                    objectStack.removeLast();
+                    lastValue = makeArray(elementStack, elementCellStack, arrayStartStack);
                     break;
                 }
 
@@ -318,8 +351,10 @@ JSValue LiteralParser::parse(ParserState initialState)
                 goto startParseExpression;
             }
             case DoParseArrayEndExpression: {
-                 asArray(objectStack.last())->push(m_exec, lastValue);
-                
+                elementStack.append(lastValue);
+                if (lastValue.isCell())
+                    elementCellStack.append(lastValue);
+
                 if (m_lexer.currentToken().type == TokComma)
                     goto doParseArrayStartExpression;
 
@@ -327,8 +362,7 @@ JSValue LiteralParser::parse(ParserState initialState)
                     return JSValue();
                 
                 m_lexer.next();
-                lastValue = objectStack.last();
-                objectStack.removeLast();
+                lastValue = makeArray(elementStack, elementCellStack, arrayStartStack);
                 break;
             }
             startParseObject:
@@ -345,7 +379,7 @@ JSValue LiteralParser::parse(ParserState initialState)
                         return JSValue();
                     
                     m_lexer.next();
-                    identifierStack.append(Identifier(m_exec, identifierToken.stringToken));
+                    identifierStack.append(makeIdentifier(identifierToken));
                     stateStack.append(DoParseObjectEndExpression);
                     goto startParseExpression;
                 } else if (type != TokRBrace) 
@@ -367,7 +401,7 @@ JSValue LiteralParser::parse(ParserState initialState)
                     return JSValue();
 
                 m_lexer.next();
-                identifierStack.append(Identifier(m_exec, identifierToken.stringToken));
+                identifierStack.append(makeIdentifier(identifierToken));
                 stateStack.append(DoParseObjectEndExpression);
                 goto startParseExpression;
             }
@@ -394,7 +428,7 @@ JSValue LiteralParser::parse(ParserState initialState)
                     case TokString: {
                         Lexer::LiteralParserToken stringToken = m_lexer.currentToken();
                         m_lexer.next();
-                        lastValue = jsString(m_exec, stringToken.stringToken);
+                        lastValue = jsString(m_exec, makeString(stringToken));
                         break;
                     }
                     case TokNumber: {
@@ -26,12 +26,44 @@
 #ifndef LiteralParser_h
 #define LiteralParser_h
 
+#include "ArgList.h"
+#include "Identifier.h"
 #include "JSGlobalObjectFunctions.h"
 #include "JSValue.h"
 #include "UString.h"
 
+#if CPU(X86_64) || (CPU(X86) && defined(__SSE2__))
+#include <emmintrin.h>
+#endif
+
 namespace JSC {
 
+    // Returns the first character from ptr on that cannot appear as is in a JSON
+    // string: a control character, '"' or '\\'. Looks at eight characters at a time
+    // where SSE2 is available.
+    inline const UChar* findJSONSpecialCharacter(const UChar* ptr, const UChar* end)
+    {
+#if CPU(X86_64) || (CPU(X86) && defined(__SSE2__))
+        const __m128i lastControlCharacter = _mm_set1_epi16(0x1F);
+        const __m128i quote = _mm_set1_epi16('"');
+        const __m128i backslash = _mm_set1_epi16('\\');
+        const __m128i zero = _mm_setzero_si128();
+        while (end - ptr >= 8) {
+            __m128i characters = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+            // The saturating subtraction only gives zero for characters up to 0x1F.
+            __m128i special = _mm_cmpeq_epi16(_mm_subs_epu16(characters, lastControlCharacter), zero);
+            special = _mm_or_si128(special, _mm_cmpeq_epi16(characters, quote));
+            special = _mm_or_si128(special, _mm_cmpeq_epi16(characters, backslash));
+            if (_mm_movemask_epi8(special))
+                break;
+            ptr += 8;
+        }
+#endif
+        while (ptr < end && *ptr > 0x1F && *ptr != '"' && *ptr != '\\')
+            ++ptr;
+        return ptr;
+    }
+
     class LiteralParser {
     public:
         typedef enum { StrictJSON, NonStrictJSON } ParserMode;
@@ -67,6 +99,10 @@ namespace JSC {
                 const UChar* start;
                 const UChar* end;
                 UString stringToken;
+                // Set instead of stringToken for strings without escape sequences,
+                // which are then only copied out of the source if needed.
+                const UChar* stringStart;
+                unsigned stringLength;
                 double numberToken;
             };
             Lexer(const UString& s, ParserMode mode)
@@ -100,6 +136,16 @@ namespace JSC {
         
         class StackGuard;
         JSValue parse(ParserState);
+        JSValue makeArray(Vector<JSValue, 16>& elements, MarkedArgumentBuffer& elementCells, Vector<size_t, 16>& arrayStarts);
+
+        UString makeString(const Lexer::LiteralParserToken& token)
+        {
+            return token.stringStart ? UString(token.stringStart, token.stringLength) : token.stringToken;
+        }
+        Identifier makeIdentifier(const Lexer::LiteralParserToken& token)
+        {
+            return token.stringStart ? Identifier(m_exec, token.stringStart, token.stringLength) : Identifier(m_exec, token.stringToken);
+        }
 
         ExecState* m_exec;
         LiteralParser::Lexer m_lexer;
@@ -24,6 +24,7 @@
 #include "RegExp.h"
 
 #include "Lexer.h"
+#include "RegExpCache.h"
 #include "yarr/Yarr.h"
 #include "yarr/YarrJIT.h"
 #include <stdio.h>
@@ -123,6 +124,8 @@ RegExp::RegExpState RegExp::compile(JSGlobalData* globalData)
             return JITCode;
 #endif
     }
+    if (globalData->canUseJIT() && res == ByteCode)
+        globalData->regExpCache()->didFallBackToInterpreter(m_patternString, m_flags);
 #endif
 
     m_representation->m_regExpBytecode = Yarr::byteCompile(pattern, &globalData->m_regExpAllocator);
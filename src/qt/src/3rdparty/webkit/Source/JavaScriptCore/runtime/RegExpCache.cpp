@@ -29,49 +29,87 @@
 
 #include "RegExpCache.h"
 
+#include <stdlib.h>
+
 namespace JSC {
 
-PassRefPtr<RegExp> RegExpCache::lookupOrCreate(const UString& patternString, RegExpFlags flags)
+#if PLATFORM(IOS)
+// The RegExpCache can currently hold onto multiple Mb of memory;
+// as a short-term fix some embedded platforms may wish to reduce the cache size.
+static const unsigned defaultCapacity = 32;
+static const unsigned defaultMaxPatternLength = 256;
+#else
+static const unsigned defaultCapacity = 1024;
+static const unsigned defaultMaxPatternLength = 4096;
+#endif
+
+static unsigned optionFromEnvironment(const char* name, unsigned defaultValue)
 {
-    if (patternString.length() < maxCacheablePatternLength) {
-        pair<RegExpCacheMap::iterator, bool> result = m_cacheMap.add(RegExpKey(flags, patternString), 0);
-        if (!result.second)
-            return result.first->second;
-        else
-            return create(patternString, flags, result.first);
-    }
-    return create(patternString, flags, m_cacheMap.end());
+    char* valueString = getenv(name);
+    if (!valueString)
+        return defaultValue;
+    int value = atoi(valueString);
+    return value > 0 ? value : defaultValue;
 }
 
-PassRefPtr<RegExp> RegExpCache::create(const UString& patternString, RegExpFlags flags, RegExpCacheMap::iterator iterator) 
+RegExpCache::RegExpCache(JSGlobalData* globalData)
+    : m_globalData(globalData)
+    , m_capacity(optionFromEnvironment("JavaScriptCoreRegExpCacheSize", defaultCapacity))
+    , m_maxPatternLength(optionFromEnvironment("JavaScriptCoreRegExpCacheMaxPatternLength", defaultMaxPatternLength))
+    , m_hitCount(0)
+    , m_missCount(0)
+    , m_uncacheableCount(0)
+    , m_interpreterFallbackCount(0)
 {
-    RefPtr<RegExp> regExp = RegExp::create(m_globalData, patternString, flags);
+}
 
-    if (patternString.length() >= maxCacheablePatternLength)
-        return regExp;
+RegExpCache::~RegExpCache()
+{
+    deleteAllValues(m_cacheMap);
+}
 
-    RegExpKey key = RegExpKey(flags, patternString);
-    iterator->first = key;
-    iterator->second = regExp;
+PassRefPtr<RegExp> RegExpCache::lookupOrCreate(const UString& patternString, RegExpFlags flags)
+{
+    if (patternString.length() > m_maxPatternLength) {
+        ++m_uncacheableCount;
+        return RegExp::create(m_globalData, patternString, flags);
+    }
 
-    ++m_nextKeyToEvict;
-    if (m_nextKeyToEvict == maxCacheableEntries) {
-        m_nextKeyToEvict = 0;
-        m_isFull = true;
+    RegExpKey key(flags, patternString);
+    RegExpCacheMap::iterator it = m_cacheMap.find(key);
+    if (it != m_cacheMap.end()) {
+        ++m_hitCount;
+        Entry* entry = it->second;
+        m_entries.remove(entry);
+        m_entries.append(entry);
+        return entry->regExp();
     }
-    if (m_isFull)
-        m_cacheMap.remove(RegExpKey(patternKeyArray[m_nextKeyToEvict].flagsValue, patternKeyArray[m_nextKeyToEvict].pattern));
 
-    patternKeyArray[m_nextKeyToEvict].flagsValue = key.flagsValue;
-    patternKeyArray[m_nextKeyToEvict].pattern = patternString.impl();
-    return regExp;
+    ++m_missCount;
+    RefPtr<RegExp> regExp = RegExp::create(m_globalData, patternString, flags);
+
+    if (m_cacheMap.size() >= m_capacity) {
+        Entry* leastRecentlyUsed = m_entries.head();
+        m_entries.remove(leastRecentlyUsed);
+        m_cacheMap.remove(leastRecentlyUsed->key());
+        delete leastRecentlyUsed;
+    }
+    Entry* entry = new Entry(key, regExp);
+    m_cacheMap.set(key, entry);
+    m_entries.append(entry);
+    return regExp.release();
 }
 
-RegExpCache::RegExpCache(JSGlobalData* globalData)
-    : m_globalData(globalData)
-    , m_nextKeyToEvict(-1)
-    , m_isFull(false)
+void RegExpCache::didFallBackToInterpreter(const UString& patternString, RegExpFlags flags)
 {
+    ++m_interpreterFallbackCount;
+
+    RegExpKey key(flags, patternString);
+    InterpretedPatternMap::iterator it = m_interpretedPatterns.find(key);
+    if (it != m_interpretedPatterns.end())
+        ++it->second;
+    else if (m_interpretedPatterns.size() < maxInterpretedPatterns)
+        m_interpretedPatterns.set(key, 1);
 }
 
 }
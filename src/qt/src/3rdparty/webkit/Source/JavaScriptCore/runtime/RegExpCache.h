@@ -28,7 +28,7 @@
 #include "RegExp.h"
 #include "RegExpKey.h"
 #include "UString.h"
-#include <wtf/FixedArray.h>
+#include <wtf/DoublyLinkedList.h>
 #include <wtf/HashMap.h>
 
 #ifndef RegExpCache_h
@@ -37,30 +37,70 @@
 namespace JSC {
 
 class RegExpCache {
-
-typedef HashMap<RegExpKey, RefPtr<RegExp> > RegExpCacheMap;
-
+    WTF_MAKE_NONCOPYABLE(RegExpCache); WTF_MAKE_FAST_ALLOCATED;
 public:
-    PassRefPtr<RegExp> lookupOrCreate(const UString& patternString, RegExpFlags);
-    PassRefPtr<RegExp> create(const UString& patternString, RegExpFlags, RegExpCacheMap::iterator);
     RegExpCache(JSGlobalData* globalData);
+    ~RegExpCache();
+
+    PassRefPtr<RegExp> lookupOrCreate(const UString& patternString, RegExpFlags);
+
+    // Called by RegExp when Yarr JIT could not compile a pattern, which then runs in the interpreter.
+    void didFallBackToInterpreter(const UString& patternString, RegExpFlags);
+
+    typedef HashMap<RegExpKey, unsigned> InterpretedPatternMap;
+
+    unsigned capacity() const { return m_capacity; }
+    unsigned maxPatternLength() const { return m_maxPatternLength; }
+    unsigned size() const { return m_cacheMap.size(); }
+    unsigned long long hitCount() const { return m_hitCount; }
+    unsigned long long missCount() const { return m_missCount; }
+    unsigned long long uncacheableCount() const { return m_uncacheableCount; }
+    unsigned long long interpreterFallbackCount() const { return m_interpreterFallbackCount; }
+    // How many times each pattern was compiled for the interpreter, for the first few such patterns.
+    const InterpretedPatternMap& interpretedPatterns() const { return m_interpretedPatterns; }
 
 private:
-    static const unsigned maxCacheablePatternLength = 256;
+    class Entry {
+    public:
+        Entry(const RegExpKey& key, PassRefPtr<RegExp> regExp)
+            : m_key(key)
+            , m_regExp(regExp)
+            , m_prev(0)
+            , m_next(0)
+        {
+        }
 
-#if PLATFORM(IOS)
-    // The RegExpCache can currently hold onto multiple Mb of memory;
-    // as a short-term fix some embedded platforms may wish to reduce the cache size.
-    static const int maxCacheableEntries = 32;
-#else
-    static const int maxCacheableEntries = 256;
-#endif
+        const RegExpKey& key() const { return m_key; }
+        RegExp* regExp() const { return m_regExp.get(); }
+
+        Entry* prev() const { return m_prev; }
+        Entry* next() const { return m_next; }
+        void setPrev(Entry* prev) { m_prev = prev; }
+        void setNext(Entry* next) { m_next = next; }
+
+    private:
+        RegExpKey m_key;
+        RefPtr<RegExp> m_regExp;
+        Entry* m_prev;
+        Entry* m_next;
+    };
+
+    typedef HashMap<RegExpKey, Entry*> RegExpCacheMap;
+
+    static const unsigned maxInterpretedPatterns = 64;
 
-    FixedArray<RegExpKey, maxCacheableEntries> patternKeyArray;
-    RegExpCacheMap m_cacheMap;
     JSGlobalData* m_globalData;
-    int m_nextKeyToEvict;
-    bool m_isFull;
+    unsigned m_capacity;
+    unsigned m_maxPatternLength;
+    RegExpCacheMap m_cacheMap;
+    // Least recently used first.
+    DoublyLinkedList<Entry> m_entries;
+
+    unsigned long long m_hitCount;
+    unsigned long long m_missCount;
+    unsigned long long m_uncacheableCount;
+    unsigned long long m_interpreterFallbackCount;
+    InterpretedPatternMap m_interpretedPatterns;
 };
 
 } // namespace JSC
@@ -293,16 +293,33 @@ namespace JSC {
         return asCell()->structure()->typeInfo().needsThisConversion();
     }
 
+    ALWAYS_INLINE bool MarkStack::testAndSetMarked(JSCell* cell)
+    {
+#if ENABLE(PARALLEL_GC)
+        // Only pay for compare-and-swap while other threads are marking too.
+        if (isParallel())
+            return Heap::concurrentTestAndSetMarked(cell);
+#endif
+        return Heap::testAndSetMarked(cell);
+    }
+
     ALWAYS_INLINE void MarkStack::internalAppend(JSCell* cell)
     {
         ASSERT(!m_isCheckingForDefaultMarkViolation);
         ASSERT(cell);
-        if (Heap::testAndSetMarked(cell))
+        if (testAndSetMarked(cell))
             return;
         if (cell->structure()->typeInfo().type() >= CompoundType)
             m_values.append(cell);
     }
 
+    inline void MarkStack::appendChildren(JSCell* cell)
+    {
+        ASSERT(Heap::isMarked(cell));
+        if (cell->structure()->typeInfo().type() >= CompoundType)
+            m_values.append(cell);
+    }
+
     inline StructureTransitionTable::Hash::Key StructureTransitionTable::keyForWeakGCMapFinalizer(void*, Structure* structure)
     {
         // Newer versions of the STL have an std::make_pair function that takes rvalue references.
@@ -27,11 +27,31 @@
 #define WriteBarrier_h
 
 #include "JSValue.h"
+#include "MarkedBlock.h"
 
 namespace JSC {
 class JSCell;
 class JSGlobalData;
 
+#if ENABLE(GGC)
+// Remembers old cells that may now point to young ones (see Heap::isGenerational()).
+// Stores into a cell allocated since the last collection need no barrier: it is
+// traced in full by the next collection anyway.
+inline void writeBarrier(JSGlobalData&, const JSCell* owner, JSCell* value)
+{
+    if (!owner || !value)
+        return;
+    MarkedBlock* block = MarkedBlock::blockFor(owner);
+    if (!block->isNewlyAllocated(owner))
+        block->setDirty();
+}
+
+inline void writeBarrier(JSGlobalData& globalData, const JSCell* owner, JSValue value)
+{
+    if (value.isCell())
+        writeBarrier(globalData, owner, value.asCell());
+}
+#else
 inline void writeBarrier(JSGlobalData&, const JSCell*, JSValue)
 {
 }
@@ -39,6 +59,7 @@ inline void writeBarrier(JSGlobalData&, const JSCell*, JSValue)
 inline void writeBarrier(JSGlobalData&, const JSCell*, JSCell*)
 {
 }
+#endif
 
 typedef enum { } Unknown;
 typedef JSValue* HandleSlot;
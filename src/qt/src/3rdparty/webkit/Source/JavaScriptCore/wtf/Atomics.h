@@ -114,8 +114,24 @@ inline int atomicDecrement(int volatile* addend) { return __gnu_cxx::__exchange_
 
 #endif
 
+#if ENABLE(COMPARE_AND_SWAP)
+// Stores newValue at location if it still holds expected. Returns true if the store happened.
+inline bool weakCompareAndSwap(unsigned* location, unsigned expected, unsigned newValue)
+{
+#if OS(DARWIN)
+    return OSAtomicCompareAndSwap32Barrier(expected, newValue, reinterpret_cast<volatile int32_t*>(location));
+#else
+    return __sync_bool_compare_and_swap(location, expected, newValue);
+#endif
+}
+#endif
+
 } // namespace WTF
 
+#if ENABLE(COMPARE_AND_SWAP)
+using WTF::weakCompareAndSwap;
+#endif
+
 #if USE(LOCKFREE_THREADSAFEREFCOUNTED)
 using WTF::atomicDecrement;
 using WTF::atomicIncrement;
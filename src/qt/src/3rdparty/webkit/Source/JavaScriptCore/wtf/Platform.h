@@ -589,6 +589,18 @@
 #define ENABLE_WTF_MULTIPLE_THREADS 1
 #endif
 
+/* Compare-and-swap is needed to set mark bits from several threads at once. */
+#if !defined(ENABLE_COMPARE_AND_SWAP) && (OS(DARWIN) || (COMPILER(GCC) && (CPU(X86) || CPU(X86_64))))
+#define ENABLE_COMPARE_AND_SWAP 1
+#endif
+
+/* Parallel marking has to be asked for with ENABLE_PARALLEL_GC=1: the visitChildren and
+   markChildren overrides in WebCore have not been audited for running on GC helper threads.
+   Once built, it is only used when helper threads are asked for (see MarkStackThreadSharedData). */
+#if ENABLE(PARALLEL_GC) && !(ENABLE(JSC_MULTIPLE_THREADS) && ENABLE(COMPARE_AND_SWAP) && (PLATFORM(MAC) || PLATFORM(QT)))
+#error "Parallel marking needs JSC_MULTIPLE_THREADS and compare-and-swap"
+#endif
+
 /* On Windows, use QueryPerformanceCounter by default */
 #if OS(WINDOWS)
 #define WTF_USE_QUERY_PERFORMANCE_COUNTER  1
@@ -1033,13 +1045,28 @@
 #define ENABLE_JIT 1
 #endif
 
-/* Currently only implemented for JSVALUE64, only tested on PLATFORM(MAC) */
-#if ENABLE(JIT) && USE(JSVALUE64) && PLATFORM(MAC)
+/* Currently only implemented for JSVALUE64, only tested on PLATFORM(MAC). PLATFORM(QT) on Linux x86_64
+   builds it only when ENABLE_DFG_JIT=1 is defined, and then only uses it when enabled at runtime
+   (see JSGlobalData::canUseDFGJIT()). */
+#if !defined(ENABLE_DFG_JIT) && ENABLE(JIT) && USE(JSVALUE64) && PLATFORM(MAC)
 #define ENABLE_DFG_JIT 1
+#endif
+#if ENABLE(DFG_JIT) && !(ENABLE(JIT) && USE(JSVALUE64) && (PLATFORM(MAC) || (PLATFORM(QT) && OS(LINUX) && CPU(X86_64))))
+#error "The DFG JIT is only supported with the JSVALUE64 JIT on Mac OS X and on Linux x86_64"
+#endif
+#if ENABLE(DFG_JIT)
 /* Enabled with restrictions to circumvent known performance regressions. */
 #define ENABLE_DFG_JIT_RESTRICTIONS 1
 #endif
 
+/* Generational collection (see Heap::isGenerational()) relies on write barriers in
+   JIT code. Only the JSVALUE64 baseline JIT emits them. It has to be asked for with
+   ENABLE_GGC=1: once built, the barriers and young cell tracking cost every store and
+   allocation, whether or not the mode is turned on at runtime. */
+#if ENABLE(GGC) && !(ENABLE(JIT) && USE(JSVALUE64))
+#error "Generational collection needs the JSVALUE64 JIT"
+#endif
+
 /* Ensure that either the JIT or the interpreter has been enabled. */
 #if !defined(ENABLE_INTERPRETER) && !ENABLE(JIT)
 #define ENABLE_INTERPRETER 1
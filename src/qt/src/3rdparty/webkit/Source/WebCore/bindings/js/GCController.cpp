@@ -36,6 +36,9 @@ using namespace JSC;
 
 namespace WebCore {
 
+// Longest stretch of sweeping done at once after a collection scheduled with garbageCollectSoon().
+static const double sweepSliceTime = 0.005;
+
 static void* collect(void*)
 {
     JSLock lock(SilenceAssertionsOnly);
@@ -51,6 +54,7 @@ GCController& gcController()
 
 GCController::GCController()
     : m_GCTimer(this, &GCController::gcTimerFired)
+    , m_sweepTimer(this, &GCController::sweepTimerFired)
 {
 }
 
@@ -62,7 +66,18 @@ void GCController::garbageCollectSoon()
 
 void GCController::gcTimerFired(Timer<GCController>*)
 {
-    collect(0);
+    // Only marking stops the world: sweeping is done in slices, between other tasks.
+    JSLock lock(SilenceAssertionsOnly);
+    JSDOMWindow::commonJSGlobalData()->heap.collectAllGarbageIncrementally();
+    m_sweepTimer.startOneShot(0);
+}
+
+void GCController::sweepTimerFired(Timer<GCController>*)
+{
+    JSLock lock(SilenceAssertionsOnly);
+    Heap& heap = JSDOMWindow::commonJSGlobalData()->heap;
+    if (heap.isBusy() || !heap.sweepIncrementally(sweepSliceTime))
+        m_sweepTimer.startOneShot(0);
 }
 
 void GCController::garbageCollectNow()
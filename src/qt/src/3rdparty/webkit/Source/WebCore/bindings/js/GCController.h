@@ -43,8 +43,10 @@ namespace WebCore {
     private:
         GCController(); // Use gcController() instead
         void gcTimerFired(Timer<GCController>*);
+        void sweepTimerFired(Timer<GCController>*);
         
         Timer<GCController> m_GCTimer;
+        Timer<GCController> m_sweepTimer;
     };
 
     // Function to obtain the global GC controller.
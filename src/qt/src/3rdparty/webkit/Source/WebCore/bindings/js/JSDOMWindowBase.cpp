@@ -35,6 +35,7 @@
 #include "SecurityOrigin.h"
 #include "Settings.h"
 #include "WebCoreJSClientData.h"
+#include <profiler/Profiler.h>
 #include <wtf/Threading.h>
 #include <wtf/text/StringConcatenate.h>
 
@@ -92,6 +93,10 @@ ExecState* JSDOMWindowBase::globalExec()
 
 bool JSDOMWindowBase::supportsProfiling() const
 {
+    // The sampling profiler needs the profiler hooks compiled in, whatever the inspector says.
+    if (Profiler::profiler()->isSampling())
+        return true;
+
 #if !ENABLE(JAVASCRIPT_DEBUGGER) || !ENABLE(INSPECTOR)
     return false;
 #else
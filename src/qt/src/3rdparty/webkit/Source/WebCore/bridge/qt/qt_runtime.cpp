@@ -27,7 +27,11 @@
 #include "DumpRenderTreeSupportQt.h"
 #include "FunctionPrototype.h"
 #include "Interpreter.h"
+#include "ArrayBuffer.h"
+#include "ArrayBufferView.h"
 #include "JSArray.h"
+#include "JSArrayBuffer.h"
+#include "JSArrayBufferView.h"
 #include "JSByteArray.h"
 #include "JSDocument.h"
 #include "JSDOMBinding.h"
@@ -104,7 +108,8 @@ typedef enum {
     Object,
     Null,
     RTArray,
-    JSByteArray
+    JSByteArray,
+    TypedArray
 } JSRealType;
 
 #if defined(QTWK_RUNTIME_CONVERSION_DEBUG) || defined(QTWK_RUNTIME_MATCH_DEBUG)
@@ -174,6 +179,8 @@ static JSRealType valueRealType(ExecState* exec, JSValue val)
             return RegExp;
         else if (object->inherits(&RuntimeObject::s_info))
             return QObj;
+        else if (object->inherits(&JSArrayBufferView::s_info) || object->inherits(&JSArrayBuffer::s_info))
+            return TypedArray;
         return Object;
     }
 
@@ -269,6 +276,7 @@ QVariant convertValueToQVariant(ExecState* exec, JSValue value, QMetaType::Type
                 hint = QMetaType::QObjectStar;
                 break;
             case JSByteArray:
+            case TypedArray:
                 hint = QMetaType::QByteArray;
                 break;
             case Array:
@@ -398,6 +406,7 @@ QVariant convertValueToQVariant(ExecState* exec, JSValue value, QMetaType::Type
                 QVariantList result;
                 int len = rtarray->getLength();
                 int objdist = 0;
+                result.reserve(len);
                 qConvDebug() << "converting a " << len << " length Array";
                 for (int i = 0; i < len; ++i) {
                     JSValue val = rtarray->getConcreteArray()->valueAt(exec, i);
@@ -417,6 +426,7 @@ QVariant convertValueToQVariant(ExecState* exec, JSValue value, QMetaType::Type
                 QVariantList result;
                 int len = array->length();
                 int objdist = 0;
+                result.reserve(len);
                 qConvDebug() << "converting a " << len << " length Array";
                 for (int i = 0; i < len; ++i) {
                     JSValue val = array->get(exec, i);
@@ -492,6 +502,15 @@ QVariant convertValueToQVariant(ExecState* exec, JSValue value, QMetaType::Type
                 WTF::ByteArray* arr = asByteArray(value)->storage();
                 ret = QVariant(QByteArray(reinterpret_cast<const char*>(arr->data()), arr->length()));
                 dist = 0;
+            } else if (type == TypedArray) {
+                // Copy the backing store in one go, rather than boxing every element
+                if (ArrayBufferView* view = toArrayBufferView(value))
+                    ret = QVariant(QByteArray(reinterpret_cast<const char*>(view->baseAddress()), view->byteLength()));
+                else {
+                    ArrayBuffer* buffer = toArrayBuffer(value);
+                    ret = QVariant(QByteArray(reinterpret_cast<const char*>(buffer->data()), buffer->byteLength()));
+                }
+                dist = 0;
             } else {
                 UString ustring = value.toString(exec);
                 ret = QVariant(QString((const QChar*)ustring.impl()->characters(), ustring.length()).toLatin1());
@@ -31,6 +31,7 @@
 
 #include "FrameLoaderTypes.h"
 #include "IconURL.h"
+#include "ResourceLoadPriority.h"
 #include "ScrollTypes.h"
 #include <wtf/Forward.h>
 #include <wtf/Vector.h>
@@ -116,6 +117,9 @@ namespace WebCore {
 
         virtual void assignIdentifierToInitialRequest(unsigned long identifier, DocumentLoader*, const ResourceRequest&) = 0;
 
+        // Lets the client override the priority a subresource is scheduled with, which defaults to one per resource type.
+        virtual ResourceLoadPriority resourceLoadPriority(const ResourceRequest&, ResourceLoadPriority defaultPriority) { return defaultPriority; }
+
         virtual void dispatchWillSendRequest(DocumentLoader*, unsigned long identifier, ResourceRequest&, const ResourceResponse& redirectResponse) = 0;
         virtual bool shouldUseCredentialStorage(DocumentLoader*, unsigned long identifier) = 0;
         virtual void dispatchDidReceiveAuthenticationChallenge(DocumentLoader*, unsigned long identifier, const AuthenticationChallenge&) = 0;
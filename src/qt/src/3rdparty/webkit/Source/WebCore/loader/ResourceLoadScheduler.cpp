@@ -32,8 +32,10 @@
 #include "KURL.h"
 #include "Logging.h"
 #include "NetscapePlugInStreamLoader.h"
+#include "Page.h"
 #include "ResourceLoader.h"
 #include "ResourceRequest.h"
+#include "Settings.h"
 #include "SubresourceLoader.h"
 #include <wtf/text/CString.h>
 
@@ -185,20 +187,30 @@ void ResourceLoadScheduler::servePendingRequests(HostInformation* host, Resource
     for (int priority = ResourceLoadPriorityHighest; priority >= minimumPriority; --priority) {
         HostInformation::RequestQueue& requestsPending = host->requestsPending(ResourceLoadPriority(priority));
 
-        while (!requestsPending.isEmpty()) {
-            RefPtr<ResourceLoader> resourceLoader = requestsPending.first();
+        HostInformation::RequestQueue::iterator it = requestsPending.begin();
+        while (it != requestsPending.end()) {
+            RefPtr<ResourceLoader> resourceLoader = *it;
 
             // For named hosts - which are only http(s) hosts - we should always enforce the connection limit.
             // For non-named hosts - everything but http(s) - we should only enforce the limit if the document isn't done parsing 
             // and we don't know all stylesheets yet.
             Document* document = resourceLoader->frameLoader() ? resourceLoader->frameLoader()->frame()->document() : 0;
             bool shouldLimitRequests = !host->name().isNull() || (document && (document->parsing() || !document->haveStylesheetsLoaded()));
-            if (shouldLimitRequests && host->limitRequests(ResourceLoadPriority(priority)))
-                return;
+            // The page the load is for may have its own limit for http(s) hosts.
+            unsigned maxRequestsInFlight = 0;
+            if (document && document->settings() && !host->name().isNull())
+                maxRequestsInFlight = document->settings()->maximumRequestsInFlightPerHost();
+            if (shouldLimitRequests && host->limitRequests(ResourceLoadPriority(priority), document ? document->page() : 0, maxRequestsInFlight)) {
+                // Only this load's page may be at its limit: let the loads of other pages through.
+                ++it;
+                continue;
+            }
 
-            requestsPending.removeFirst();
+            requestsPending.remove(it);
             host->addLoadInProgress(resourceLoader.get());
             resourceLoader->start();
+            // Starting a load may schedule or cancel others.
+            it = requestsPending.begin();
         }
     }
 }
@@ -251,13 +263,24 @@ void ResourceLoadScheduler::HostInformation::schedule(ResourceLoader* resourceLo
 void ResourceLoadScheduler::HostInformation::addLoadInProgress(ResourceLoader* resourceLoader)
 {
     LOG(ResourceLoading, "HostInformation '%s' loading '%s'. Current count %d", m_name.latin1().data(), resourceLoader->url().string().latin1().data(), m_requestsLoading.size());
-    m_requestsLoading.add(resourceLoader);
+    Page* page = resourceLoader->frameLoader() ? resourceLoader->frameLoader()->frame()->page() : 0;
+    m_requestsLoading.add(resourceLoader, page);
+    if (page) {
+        HashMap<Page*, unsigned>::iterator it = m_requestsLoadingPerPage.add(page, 0).first;
+        ++it->second;
+    }
 }
     
 void ResourceLoadScheduler::HostInformation::remove(ResourceLoader* resourceLoader)
 {
-    if (m_requestsLoading.contains(resourceLoader)) {
-        m_requestsLoading.remove(resourceLoader);
+    RequestMap::iterator loading = m_requestsLoading.find(resourceLoader);
+    if (loading != m_requestsLoading.end()) {
+        if (Page* page = loading->second) {
+            HashMap<Page*, unsigned>::iterator it = m_requestsLoadingPerPage.find(page);
+            if (!--it->second)
+                m_requestsLoadingPerPage.remove(it);
+        }
+        m_requestsLoading.remove(loading);
         return;
     }
     
@@ -283,11 +306,15 @@ bool ResourceLoadScheduler::HostInformation::hasRequests() const
     return false;
 }
 
-bool ResourceLoadScheduler::HostInformation::limitRequests(ResourceLoadPriority priority) const 
+bool ResourceLoadScheduler::HostInformation::limitRequests(ResourceLoadPriority priority, Page* page, unsigned maxRequestsInFlight) const 
 {
     if (priority == ResourceLoadPriorityVeryLow && !m_requestsLoading.isEmpty())
         return true;
-    return m_requestsLoading.size() >= (resourceLoadScheduler()->isSerialLoadingEnabled() ? 1 : m_maxRequestsInFlight);
+    if (resourceLoadScheduler()->isSerialLoadingEnabled())
+        return !m_requestsLoading.isEmpty();
+    if (page && maxRequestsInFlight)
+        return m_requestsLoadingPerPage.get(page) >= maxRequestsInFlight;
+    return m_requestsLoading.size() >= m_maxRequestsInFlight;
 }
 
 } // namespace WebCore
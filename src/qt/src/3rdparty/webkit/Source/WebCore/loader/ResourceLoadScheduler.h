@@ -40,6 +40,7 @@ class Frame;
 class KURL;
 class NetscapePlugInStreamLoader;
 class NetscapePlugInStreamLoaderClient;
+class Page;
 class ResourceLoader;
 class ResourceRequest;
 class SubresourceLoader;
@@ -82,15 +83,19 @@ private:
         void addLoadInProgress(ResourceLoader*);
         void remove(ResourceLoader*);
         bool hasRequests() const;
-        bool limitRequests(ResourceLoadPriority) const;
+        // A page with a maxRequestsInFlight of its own is only limited by its own loads,
+        // 0 stands for the host's limit, shared by every page.
+        bool limitRequests(ResourceLoadPriority, Page* = 0, unsigned maxRequestsInFlight = 0) const;
 
         typedef Deque<RefPtr<ResourceLoader> > RequestQueue;
         RequestQueue& requestsPending(ResourceLoadPriority priority) { return m_requestsPending[priority]; }
 
     private:                    
         RequestQueue m_requestsPending[ResourceLoadPriorityHighest + 1];
-        typedef HashSet<RefPtr<ResourceLoader> > RequestMap;
+        // The page each load was started for, to count them per page.
+        typedef HashMap<RefPtr<ResourceLoader>, Page*> RequestMap;
         RequestMap m_requestsLoading;
+        HashMap<Page*, unsigned> m_requestsLoadingPerPage;
         const String m_name;
         const int m_maxRequestsInFlight;
     };
@@ -325,16 +325,20 @@ CachedResource* CachedResourceLoader::requestResource(CachedResource::Type type,
 
     switch (determineRevalidationPolicy(type, forPreload, resource)) {
     case Load:
+        memoryCache()->countRequest(MemoryCache::RequestLoaded);
         resource = loadResource(type, url, charset, priority);
         break;
     case Reload:
+        memoryCache()->countRequest(MemoryCache::RequestLoaded);
         memoryCache()->remove(resource);
         resource = loadResource(type, url, charset, priority);
         break;
     case Revalidate:
+        memoryCache()->countRequest(MemoryCache::RequestRevalidated);
         resource = revalidateResource(resource, priority);
         break;
     case Use:
+        memoryCache()->countRequest(MemoryCache::RequestServedFromCache);
         memoryCache()->resourceAccessed(resource);
         notifyLoadedFromMemoryCache(resource);
         break;
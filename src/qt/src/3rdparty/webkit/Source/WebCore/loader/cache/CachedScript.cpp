@@ -30,20 +30,36 @@
 #include "MemoryCache.h"
 #include "CachedResourceClient.h"
 #include "CachedResourceClientWalker.h"
+#include "FileSystem.h"
 #include "SharedBuffer.h"
 #include "TextResourceDecoder.h"
 #include <wtf/Vector.h>
 
 #if USE(JSC)  
+#include "JSDOMWindowBase.h"
+#include <limits.h>
 #include <parser/SourceProvider.h>
+#include <runtime/JSLock.h>
+#include <wtf/SHA1.h>
+#include <wtf/text/CString.h>
+#include <wtf/text/StringBuilder.h>
 #endif
 
 namespace WebCore {
 
+#if USE(JSC)
+// The parser adds to the cache once per function: what it added within this
+// many seconds is written to disk at once.
+static const double sourceProviderCacheWriteDelay = 0.5;
+#endif
+
 CachedScript::CachedScript(const String& url, const String& charset)
     : CachedResource(url, Script)
     , m_decoder(TextResourceDecoder::create("application/javascript", charset))
     , m_decodedDataDeletionTimer(this, &CachedScript::decodedDataDeletionTimerFired)
+#if USE(JSC)
+    , m_sourceProviderCacheWriteTimer(this, &CachedScript::sourceProviderCacheWriteTimerFired)
+#endif
 {
     // It's javascript we want.
     // But some websites think their scripts are <some wrong mimetype here>
@@ -53,6 +69,10 @@ CachedScript::CachedScript(const String& url, const String& charset)
 
 CachedScript::~CachedScript()
 {
+#if USE(JSC)
+    if (m_sourceProviderCacheWriteTimer.isActive())
+        writeSourceProviderCache();
+#endif
 }
 
 void CachedScript::didAddClient(CachedResourceClient* c)
@@ -117,6 +137,8 @@ void CachedScript::destroyDecodedData()
     m_script = String();
     unsigned extraSize = 0;
 #if USE(JSC)
+    if (m_sourceProviderCacheWriteTimer.isActive())
+        writeSourceProviderCache();
     if (m_sourceProviderCache && m_clients.isEmpty())
         m_sourceProviderCache->clear();
 
@@ -133,16 +155,138 @@ void CachedScript::decodedDataDeletionTimerFired(Timer<CachedScript>*)
 }
 
 #if USE(JSC)
-JSC::SourceProviderCache* CachedScript::sourceProviderCache() const
+JSC::SourceProviderCache* CachedScript::sourceProviderCache()
 {   
-    if (!m_sourceProviderCache) 
+    if (!m_sourceProviderCache) {
         m_sourceProviderCache = adoptPtr(new JSC::SourceProviderCache); 
+        readSourceProviderCache();
+    }
     return m_sourceProviderCache.get(); 
 }
 
 void CachedScript::sourceProviderCacheSizeChanged(int delta)
 {
     setDecodedSize(decodedSize() + delta);
+    // The parser only adds to the cache after parsing functions it had not seen.
+    if (delta <= 0 || sourceProviderCacheDirectory().isEmpty() || m_sourceProviderCacheWriteTimer.isActive())
+        return;
+    // The script is decoded now, but its decoded data may be gone by the time the cache is written.
+    scriptDigest();
+    m_sourceProviderCacheWriteTimer.startOneShot(sourceProviderCacheWriteDelay);
+}
+
+void CachedScript::sourceProviderCacheWriteTimerFired(Timer<CachedScript>*)
+{
+    writeSourceProviderCache();
+}
+
+static String& sourceProviderCacheDirectoryPath()
+{
+    DEFINE_STATIC_LOCAL(String, directory, ());
+    return directory;
+}
+
+void CachedScript::setSourceProviderCacheDirectory(const String& directory)
+{
+    sourceProviderCacheDirectoryPath() = directory;
+    if (!directory.isEmpty())
+        makeAllDirectories(directory);
+}
+
+const String& CachedScript::sourceProviderCacheDirectory()
+{
+    return sourceProviderCacheDirectoryPath();
+}
+
+static String hexDigest(const Vector<uint8_t, 20>& digest)
+{
+    static const char hexDigits[] = "0123456789abcdef";
+    StringBuilder builder;
+    for (size_t i = 0; i < digest.size(); ++i) {
+        builder.append(hexDigits[digest[i] >> 4]);
+        builder.append(hexDigits[digest[i] & 0xf]);
+    }
+    return builder.toString();
+}
+
+String CachedScript::sourceProviderCachePath() const
+{
+    if (sourceProviderCacheDirectory().isEmpty() || url().isEmpty())
+        return String();
+
+    CString utf8URL = url().utf8();
+    SHA1 sha1;
+    sha1.addBytes(reinterpret_cast<const uint8_t*>(utf8URL.data()), utf8URL.length());
+    Vector<uint8_t, 20> digest;
+    sha1.computeHash(digest);
+    return pathByAppendingComponent(sourceProviderCacheDirectory(), hexDigest(digest));
+}
+
+const Vector<char>& CachedScript::scriptDigest()
+{
+    if (m_scriptDigest.isEmpty()) {
+        const String& source = script();
+        SHA1 sha1;
+        sha1.addBytes(reinterpret_cast<const uint8_t*>(source.characters()), source.length() * sizeof(UChar));
+        Vector<uint8_t, 20> digest;
+        sha1.computeHash(digest);
+        m_scriptDigest.append(reinterpret_cast<const char*>(digest.data()), digest.size());
+    }
+    return m_scriptDigest;
+}
+
+// A cache file holds the digest of the script it was computed for, followed by
+// the encoded cache: a file for an older version of the script is ignored, and
+// overwritten once the new version has been parsed.
+void CachedScript::readSourceProviderCache()
+{
+    String path = sourceProviderCachePath();
+    long long fileSize;
+    if (path.isEmpty() || !getFileSize(path, fileSize) || fileSize <= static_cast<long long>(scriptDigest().size()) || fileSize > INT_MAX)
+        return;
+
+    PlatformFileHandle handle = openFile(path, OpenForRead);
+    if (!isHandleValid(handle))
+        return;
+    Vector<char> buffer(static_cast<size_t>(fileSize));
+    int bytesRead = readFromFile(handle, buffer.data(), buffer.size());
+    closeFile(handle);
+    if (bytesRead != static_cast<int>(buffer.size()))
+        return;
+
+    const Vector<char>& digest = scriptDigest();
+    if (memcmp(buffer.data(), digest.data(), digest.size()))
+        return;
+
+    const String& source = script();
+    JSC::JSLock lock(JSC::SilenceAssertionsOnly);
+    if (!m_sourceProviderCache->decode(JSDOMWindowBase::commonJSGlobalData(), buffer.data() + digest.size(), buffer.size() - digest.size(), source.characters(), source.length()))
+        return;
+    setDecodedSize(decodedSize() + m_sourceProviderCache->byteSize());
+}
+
+void CachedScript::writeSourceProviderCache()
+{
+    m_sourceProviderCacheWriteTimer.stop();
+
+    // The digest was computed when the write was scheduled.
+    String path = sourceProviderCachePath();
+    if (path.isEmpty() || m_scriptDigest.isEmpty() || !m_sourceProviderCache || m_sourceProviderCache->isEmpty())
+        return;
+
+    Vector<char> buffer;
+    buffer.append(m_scriptDigest.data(), m_scriptDigest.size());
+    m_sourceProviderCache->encode(buffer);
+
+    PlatformFileHandle handle = openFile(path, OpenForWrite);
+    if (!isHandleValid(handle))
+        return;
+    if (writeToFile(handle, buffer.data(), buffer.size()) != static_cast<int>(buffer.size())) {
+        closeFile(handle);
+        deleteFile(path);
+        return;
+    }
+    closeFile(handle);
 }
 #endif
 
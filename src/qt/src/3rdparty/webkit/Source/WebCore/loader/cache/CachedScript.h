@@ -58,18 +58,32 @@ namespace WebCore {
         virtual void destroyDecodedData();
 #if USE(JSC)        
         // Allows JSC to cache additional information about the source.
-        JSC::SourceProviderCache* sourceProviderCache() const;
+        JSC::SourceProviderCache* sourceProviderCache();
         void sourceProviderCacheSizeChanged(int delta);
+
+        // Keeps that information on disk too, under the script URL, for as long as the
+        // script content does not change. Off when the directory is empty (the default).
+        static void setSourceProviderCacheDirectory(const String&);
+        static const String& sourceProviderCacheDirectory();
 #endif
     private:
         void decodedDataDeletionTimerFired(Timer<CachedScript>*);
+#if USE(JSC)
+        String sourceProviderCachePath() const;
+        const Vector<char>& scriptDigest();
+        void readSourceProviderCache();
+        void writeSourceProviderCache();
+        void sourceProviderCacheWriteTimerFired(Timer<CachedScript>*);
+#endif
         virtual PurgePriority purgePriority() const { return PurgeLast; }
 
         String m_script;
         RefPtr<TextResourceDecoder> m_decoder;
         Timer<CachedScript> m_decodedDataDeletionTimer;
 #if USE(JSC)        
-        mutable OwnPtr<JSC::SourceProviderCache> m_sourceProviderCache;
+        OwnPtr<JSC::SourceProviderCache> m_sourceProviderCache;
+        Vector<char> m_scriptDigest;
+        Timer<CachedScript> m_sourceProviderCacheWriteTimer;
 #endif
     };
 }
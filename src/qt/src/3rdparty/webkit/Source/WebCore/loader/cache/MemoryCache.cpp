@@ -68,6 +68,8 @@ MemoryCache::MemoryCache()
     , m_liveSize(0)
     , m_deadSize(0)
 {
+    for (int i = 0; i < RequestOutcomeCount; ++i)
+        m_requestCounts[i] = 0;
 }
 
 KURL MemoryCache::removeFragmentIdentifierIfNeeded(const KURL& originalURL)
@@ -172,6 +174,11 @@ void MemoryCache::pruneLiveResources()
         return;
 
     unsigned targetSize = static_cast<unsigned>(capacity * cTargetPrunePercentage); // Cut by a percentage to avoid immediately pruning again.
+    pruneLiveResourcesToSize(targetSize);
+}
+
+void MemoryCache::pruneLiveResourcesToSize(unsigned targetSize)
+{
     double currentTime = FrameView::currentPaintTimeStamp();
     if (!currentTime) // In case prune is called directly, outside of a Frame paint.
         currentTime = WTF::currentTime();
@@ -216,6 +223,11 @@ void MemoryCache::pruneDeadResources()
         return;
 
     unsigned targetSize = static_cast<unsigned>(capacity * cTargetPrunePercentage); // Cut by a percentage to avoid immediately pruning again.
+    pruneDeadResourcesToSize(targetSize);
+}
+
+void MemoryCache::pruneDeadResourcesToSize(unsigned targetSize)
+{
     int size = m_allResources.size();
     
     if (!m_inPruneDeadResources) {
@@ -290,6 +302,19 @@ void MemoryCache::pruneDeadResources()
     m_inPruneDeadResources = false;
 }
 
+void MemoryCache::pruneToPercentage(float targetPercentLive)
+{
+    unsigned targetSize = static_cast<unsigned>((m_liveSize + m_deadSize) * targetPercentLive);
+    // Dead resources go first, down to what the live ones leave of the target.
+    unsigned targetDeadSize = targetSize > m_liveSize ? targetSize - m_liveSize : 0;
+    if (m_deadSize > targetDeadSize || !targetSize)
+        pruneDeadResourcesToSize(targetDeadSize);
+    // Then live resources, down to what the dead ones left over.
+    unsigned targetLiveSize = targetSize > m_deadSize ? targetSize - m_deadSize : 0;
+    if (m_liveSize > targetLiveSize || !targetSize)
+        pruneLiveResourcesToSize(targetLiveSize);
+}
+
 void MemoryCache::setCapacities(unsigned minDeadBytes, unsigned maxDeadBytes, unsigned totalBytes)
 {
     ASSERT(minDeadBytes <= maxDeadBytes);
@@ -140,6 +140,10 @@ public:
         pruneLiveResources();
     }
 
+    // Flushes data until the cache is down to the given fraction of its current size, dead
+    // resources first. Resources still referenced by Web pages only lose their decoded data.
+    void pruneToPercentage(float targetPercentLive);
+
     void setDeadDecodedDataDeletionInterval(double interval) { m_deadDecodedDataDeletionInterval = interval; }
     double deadDecodedDataDeletionInterval() const { return m_deadDecodedDataDeletionInterval; }
 
@@ -164,6 +168,17 @@ public:
 
     // Function to collect cache statistics for the caches window in the Safari Debug menu.
     Statistics getStatistics();
+
+    unsigned capacity() const { return m_capacity; }
+    unsigned minDeadCapacity() const { return m_minDeadCapacity; }
+    unsigned maxDeadCapacity() const { return m_maxDeadCapacity; }
+    unsigned liveSize() const { return m_liveSize; }
+    unsigned deadSize() const { return m_deadSize; }
+
+    // How the requests of CachedResourceLoaders were served, for statistics.
+    enum RequestOutcome { RequestServedFromCache, RequestRevalidated, RequestLoaded, RequestOutcomeCount };
+    void countRequest(RequestOutcome outcome) { ++m_requestCounts[outcome]; }
+    unsigned long long requestCount(RequestOutcome outcome) const { return m_requestCounts[outcome]; }
     
     void resourceAccessed(CachedResource*);
 
@@ -186,6 +201,8 @@ private:
     
     void pruneDeadResources(); // Flush decoded and encoded data from resources not referenced by Web pages.
     void pruneLiveResources(); // Flush decoded data from resources still referenced by Web pages.
+    void pruneDeadResourcesToSize(unsigned targetSize);
+    void pruneLiveResourcesToSize(unsigned targetSize);
 
     bool makeResourcePurgeable(CachedResource*);
     void evict(CachedResource*);
@@ -202,6 +219,8 @@ private:
     unsigned m_liveSize; // The number of bytes currently consumed by "live" resources in the cache.
     unsigned m_deadSize; // The number of bytes currently consumed by "dead" resources in the cache.
 
+    unsigned long long m_requestCounts[RequestOutcomeCount];
+
     // Size-adjusted and popularity-aware LRU list collection for cache objects.  This collection can hold
     // more resources than the cached resource map, since it can also hold "stale" multiple versions of objects that are
     // waiting to die when the clients referencing them go away.
@@ -96,6 +96,7 @@ Settings::Settings(Page* page)
     , m_defaultFixedFontSize(0)
     , m_validationMessageTimerMagnification(50)
     , m_maximumDecodedImageSize(numeric_limits<size_t>::max())
+    , m_maximumRequestsInFlightPerHost(0)
 #if ENABLE(DOM_STORAGE)
     , m_sessionStorageQuota(StorageMap::noQuota)
 #endif
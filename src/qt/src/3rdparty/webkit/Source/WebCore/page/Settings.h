@@ -270,6 +270,10 @@ namespace WebCore {
         void setMaximumDecodedImageSize(size_t size) { m_maximumDecodedImageSize = size; }
         size_t maximumDecodedImageSize() const { return m_maximumDecodedImageSize; }
 
+        // How many loads the ResourceLoadScheduler lets this page's frames have in flight to one host; 0 keeps its default.
+        void setMaximumRequestsInFlightPerHost(unsigned count) { m_maximumRequestsInFlightPerHost = count; }
+        unsigned maximumRequestsInFlightPerHost() const { return m_maximumRequestsInFlightPerHost; }
+
 #if USE(SAFARI_THEME)
         // Windows debugging pref (global) for switching between the Aqua look and a native windows look.
         static void setShouldPaintNativeControls(bool);
@@ -435,6 +439,7 @@ namespace WebCore {
         int m_defaultFixedFontSize;
         int m_validationMessageTimerMagnification;
         size_t m_maximumDecodedImageSize;
+        unsigned m_maximumRequestsInFlightPerHost;
 #if ENABLE(DOM_STORAGE)
         unsigned m_sessionStorageQuota;
 #endif
@@ -61,6 +61,8 @@ BitmapImage::BitmapImage(ImageObserver* observer)
     , m_hasUniformFrameSize(true)
     , m_decodedSize(0)
     , m_decodedPropertiesSize(0)
+    , m_decodingAheadSize(0)
+    , m_decodeAheadRequested(false)
     , m_haveFrameCount(false)
     , m_frameCount(0)
 {
@@ -76,16 +78,29 @@ BitmapImage::~BitmapImage()
 void BitmapImage::destroyDecodedData(bool destroyAll)
 {
     int framesCleared = 0;
+    unsigned frameBytesCleared = 0;
     const size_t clearBeforeFrame = destroyAll ? m_frames.size() : m_currentFrame;
     for (size_t i = 0; i < clearBeforeFrame; ++i) {
         // The underlying frame isn't actually changing (we're just trying to
         // save the memory for the framebuffer data), so we don't need to clear
         // the metadata.
-        if (m_frames[i].clear(false))
+        if (m_frames[i].clear(false)) {
           ++framesCleared;
+          frameBytesCleared += m_frames[i].m_frameBytes;
+        }
+        m_frames[i].m_frameBytes = 0;
     }
 
-    destroyMetadataAndNotify(framesCleared);
+    destroyMetadataAndNotify(framesCleared, frameBytesCleared);
+
+    // Clearing the source drops the frame it was decoding ahead. The new decoder
+    // does not start over: the frame gets decoded if and when it is drawn.
+    if (destroyAll && m_decodingAheadSize) {
+        int deltaBytes = -static_cast<int>(m_decodingAheadSize);
+        m_decodingAheadSize = 0;
+        if (imageObserver())
+            imageObserver()->decodedSizeChanged(this, deltaBytes);
+    }
 
     m_source.clear(destroyAll, clearBeforeFrame, data(), m_allDataReceived);
     return;
@@ -100,13 +115,13 @@ void BitmapImage::destroyDecodedDataIfNecessary(bool destroyAll)
         destroyDecodedData(destroyAll);
 }
 
-void BitmapImage::destroyMetadataAndNotify(int framesCleared)
+void BitmapImage::destroyMetadataAndNotify(int framesCleared, unsigned frameBytesCleared)
 {
     m_isSolidColor = false;
     m_checkedForSolidColor = false;
     invalidatePlatformData();
 
-    int deltaBytes = framesCleared * -frameBytes(m_size);
+    int deltaBytes = -static_cast<int>(frameBytesCleared);
     m_decodedSize += deltaBytes;
     if (framesCleared > 0) {
         deltaBytes -= m_decodedPropertiesSize;
@@ -137,16 +152,57 @@ void BitmapImage::cacheFrame(size_t index)
     const IntSize frameSize(index ? m_source.frameSizeAtIndex(index) : m_size);
     if (frameSize != m_size)
         m_hasUniformFrameSize = false;
+
+    // The frame decoded ahead, if any, is now either a decoded frame or gone.
+    int deltaBytes = 0;
+    if (!index && m_decodingAheadSize) {
+        deltaBytes -= m_decodingAheadSize;
+        m_decodingAheadSize = 0;
+    }
     if (m_frames[index].m_frame) {
-        int deltaBytes = frameBytes(frameSize);
-        m_decodedSize += deltaBytes;
+        // Oversized images are decoded scaled down, so count what was decoded.
+        int frameDeltaBytes = frameBytes(m_source.decodedFrameSizeAtIndex(index));
+        m_frames[index].m_frameBytes = frameDeltaBytes;
+        m_decodedSize += frameDeltaBytes;
         // The fully-decoded frame will subsume the partially decoded data used
         // to determine image properties.
-        deltaBytes -= m_decodedPropertiesSize;
+        deltaBytes += frameDeltaBytes - m_decodedPropertiesSize;
         m_decodedPropertiesSize = 0;
-        if (imageObserver())
-            imageObserver()->decodedSizeChanged(this, deltaBytes);
     }
+    if (deltaBytes && imageObserver())
+        imageObserver()->decodedSizeChanged(this, deltaBytes);
+}
+
+void BitmapImage::willDraw()
+{
+    // Only the first time: after destroyDecodedData(), frames are decoded when drawn.
+    if (m_decodeAheadRequested || !m_allDataReceived || !isSizeAvailable())
+        return;
+    m_decodeAheadRequested = true;
+
+    if ((!m_frames.isEmpty() && m_frames[0].m_frame) || !m_source.startDecodingAhead())
+        return;
+
+    // Memory for the frame is taken now, so account for it now.
+    m_decodingAheadSize = frameBytes(m_source.decodedFrameSizeAtIndex(0));
+    if (imageObserver())
+        imageObserver()->decodedSizeChanged(this, m_decodingAheadSize);
+}
+
+void BitmapImage::willDrawAtSize(const IntSize& drawnSize)
+{
+    IntSize largestDrawnSize = m_largestDrawnSize.expandedTo(drawnSize.shrunkTo(size()));
+    if (largestDrawnSize == m_largestDrawnSize)
+        return;
+    m_largestDrawnSize = largestDrawnSize;
+    m_source.setMinimumDecodedSize(largestDrawnSize);
+
+    // A still image decoded scaled down, now drawn larger than that, is decoded again.
+    if (!m_allDataReceived || m_frames.size() != 1 || !m_frames[0].m_frame)
+        return;
+    IntSize decodedSize = m_source.decodedFrameSizeAtIndex(0);
+    if (!decodedSize.isEmpty() && (decodedSize.width() < largestDrawnSize.width() || decodedSize.height() < largestDrawnSize.height()))
+        destroyDecodedData(true);
 }
 
 void BitmapImage::didDecodeProperties() const
@@ -77,6 +77,7 @@ public:
         , m_isComplete(false)
         , m_duration(0)
         , m_hasAlpha(true) 
+        , m_frameBytes(0)
     {
     }
 
@@ -94,6 +95,7 @@ public:
     bool m_isComplete;
     float m_duration;
     bool m_hasAlpha;
+    unsigned m_frameBytes; // The memory taken by m_frame, which may be decoded scaled down.
 };
 
 // =================================================
@@ -131,7 +133,9 @@ public:
     virtual void stopAnimation();
     virtual void resetAnimation();
     
-    virtual unsigned decodedSize() const { return m_decodedSize; }
+    virtual unsigned decodedSize() const { return m_decodedSize + m_decodingAheadSize; }
+    virtual void willDraw();
+    virtual void willDrawAtSize(const IntSize&);
 
 #if PLATFORM(MAC)
     // Accessors for native image formats.
@@ -214,8 +218,8 @@ protected:
 
     // Generally called by destroyDecodedData(), destroys whole-image metadata
     // and notifies observers that the memory footprint has (hopefully)
-    // decreased by |framesCleared| times the size (in bytes) of a frame.
-    void destroyMetadataAndNotify(int framesCleared);
+    // decreased by |frameBytesCleared|, the size of the |framesCleared| frames.
+    void destroyMetadataAndNotify(int framesCleared, unsigned frameBytesCleared);
 
     // Whether or not size is available yet.    
     bool isSizeAvailable();
@@ -293,6 +297,9 @@ protected:
 
     unsigned m_decodedSize; // The current size of all decoded frames.
     mutable unsigned m_decodedPropertiesSize; // The size of data decoded by the source to determine image properties (e.g. size, frame count, etc).
+    unsigned m_decodingAheadSize; // The size of the first frame while the source decodes it ahead of drawing.
+    bool m_decodeAheadRequested; // Whether willDraw() has been handled; kept when the source is cleared.
+    IntSize m_largestDrawnSize; // The largest size, up to m_size, the image has been drawn at (see willDrawAtSize()).
 
     mutable bool m_haveFrameCount;
     size_t m_frameCount;
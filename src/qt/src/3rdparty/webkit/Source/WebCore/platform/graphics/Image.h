@@ -116,6 +116,11 @@ public:
     virtual void destroyDecodedData(bool destroyAll = true) = 0;
     virtual unsigned decodedSize() const = 0;
 
+    // Hints that the image is about to be drawn, so that decoding can start ahead of it.
+    virtual void willDraw() { }
+    // Tells the size in device pixels that the whole image is about to be drawn at.
+    virtual void willDrawAtSize(const IntSize&) { }
+
     SharedBuffer* data() { return m_data.get(); }
 
     // Animation begins whenever someone draws the image, so startAnimation() is not normally called.
@@ -84,6 +84,8 @@ void ImageSource::setData(SharedBuffer* data, bool allDataReceived)
         if (m_decoder && s_maxPixelsPerDecodedImage)
             m_decoder->setMaxNumPixels(s_maxPixelsPerDecodedImage);
 #endif
+        if (m_decoder)
+            m_decoder->setMinimumDecodedSize(m_minimumDecodedSize);
     }
 
     if (m_decoder)
@@ -110,6 +112,11 @@ IntSize ImageSource::frameSizeAtIndex(size_t index) const
     return m_decoder ? m_decoder->frameSizeAtIndex(index) : IntSize();
 }
 
+IntSize ImageSource::decodedFrameSizeAtIndex(size_t index) const
+{
+    return m_decoder ? m_decoder->decodedFrameSizeAtIndex(index) : IntSize();
+}
+
 bool ImageSource::getHotSpot(IntPoint&) const
 {
     return false;
@@ -149,6 +156,18 @@ NativeImagePtr ImageSource::createFrameAtIndex(size_t index)
     return buffer->asNewNativeImage();
 }
 
+bool ImageSource::startDecodingAhead()
+{
+    return m_decoder && m_decoder->startDecodingAhead();
+}
+
+void ImageSource::setMinimumDecodedSize(const IntSize& size)
+{
+    m_minimumDecodedSize = size;
+    if (m_decoder)
+        m_decoder->setMinimumDecodedSize(size);
+}
+
 float ImageSource::frameDurationAtIndex(size_t index)
 {
     if (!m_decoder)
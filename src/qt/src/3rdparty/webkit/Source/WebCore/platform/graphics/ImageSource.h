@@ -27,6 +27,7 @@
 #ifndef ImageSource_h
 #define ImageSource_h
 
+#include "IntSize.h"
 #include <wtf/Forward.h>
 #include <wtf/Noncopyable.h>
 #include <wtf/Vector.h>
@@ -59,7 +60,6 @@ class BBitmap;
 namespace WebCore {
 
 class IntPoint;
-class IntSize;
 class SharedBuffer;
 
 #if USE(CG)
@@ -167,6 +167,7 @@ public:
     bool isSizeAvailable();
     IntSize size() const;
     IntSize frameSizeAtIndex(size_t) const;
+    IntSize decodedFrameSizeAtIndex(size_t) const; // The size the frame takes once decoded.
     bool getHotSpot(IntPoint&) const;
 
     size_t bytesDecodedToDetermineProperties() const;
@@ -179,6 +180,14 @@ public:
     // see comments on clear() above.
     NativeImagePtr createFrameAtIndex(size_t);
 
+    // Has the first frame decoded in the background, ahead of createFrameAtIndex(0).
+    // Returns false if the source does not do that, or not for this image.
+    bool startDecodingAhead();
+
+    // Frames decoded scaled down are not made smaller than this, also by the
+    // decoders that replace the current one.
+    void setMinimumDecodedSize(const IntSize&);
+
     float frameDurationAtIndex(size_t);
     bool frameHasAlphaAtIndex(size_t); // Whether or not the frame actually used any alpha.
     bool frameIsCompleteAtIndex(size_t); // Whether or not the frame is completely decoded.
@@ -192,6 +201,7 @@ private:
     NativeImageSourcePtr m_decoder;
     AlphaOption m_alphaOption;
     GammaAndColorProfileOption m_gammaAndColorProfileOption;
+    IntSize m_minimumDecodedSize;
 #if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
     static unsigned s_maxPixelsPerDecodedImage;
 #endif
@@ -81,6 +81,8 @@ BitmapImage::BitmapImage(CGImageRef cgImage, ImageObserver* observer)
     , m_haveSize(true)
     , m_sizeAvailable(true)
     , m_decodedSize(0)
+    , m_decodingAheadSize(0)
+    , m_decodeAheadRequested(false)
     , m_haveFrameCount(true)
     , m_frameCount(1)
 {
@@ -93,6 +95,7 @@ BitmapImage::BitmapImage(CGImageRef cgImage, ImageObserver* observer)
 
     m_frames.grow(1);
     m_frames[0].m_frame = cgImage;
+    m_frames[0].m_frameBytes = m_decodedSize;
     m_frames[0].m_hasAlpha = true;
     m_frames[0].m_haveMetadata = true;
     checkForSolidColor();
@@ -200,6 +200,11 @@ IntSize ImageSource::frameSizeAtIndex(size_t index) const
     return result;
 }
 
+IntSize ImageSource::decodedFrameSizeAtIndex(size_t index) const
+{
+    return frameSizeAtIndex(index);
+}
+
 IntSize ImageSource::size() const
 {
     return frameSizeAtIndex(0);
@@ -287,6 +292,15 @@ CGImageRef ImageSource::createFrameAtIndex(size_t index)
     return maskedImage.releaseRef();
 }
 
+bool ImageSource::startDecodingAhead()
+{
+    return false;
+}
+
+void ImageSource::setMinimumDecodedSize(const IntSize&)
+{
+}
+
 bool ImageSource::frameIsCompleteAtIndex(size_t index)
 {
     ASSERT(frameCount());
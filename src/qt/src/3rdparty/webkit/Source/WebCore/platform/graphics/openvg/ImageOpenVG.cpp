@@ -67,6 +67,8 @@ BitmapImage::BitmapImage(TiledImageOpenVG* tiledImage, ImageObserver* observer)
     , m_haveSize(true)
     , m_sizeAvailable(true)
     , m_hasUniformFrameSize(true)
+    , m_decodingAheadSize(0)
+    , m_decodeAheadRequested(false)
     , m_haveFrameCount(true)
     , m_frameCount(1)
 {
@@ -78,6 +80,7 @@ BitmapImage::BitmapImage(TiledImageOpenVG* tiledImage, ImageObserver* observer)
     m_decodedSize = m_size.width() * m_size.height() * 4;
 
     m_frames[0].m_frame = tiledImage;
+    m_frames[0].m_frameBytes = m_decodedSize;
     m_frames[0].m_hasAlpha = true;
     m_frames[0].m_isComplete = true;
     m_frames[0].m_haveMetadata = true;
@@ -31,12 +31,160 @@
 
 #include <QtCore/QByteArray>
 #include <QtCore/QBuffer>
+#include <QtCore/QMutex>
+#include <QtCore/QRunnable>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtCore/QWaitCondition>
 
 #include <QtGui/QImageReader>
 #include <qdebug.h>
+#include <wtf/MathExtras.h>
 
 namespace WebCore {
 
+// The decode of the first frame of a still image, shared between the decoder and a
+// thread of the pool. Whichever thread gets to it first decodes: the decoder does
+// not wait for a decode that has not started, it runs it itself. The encoded data
+// is read in place, from the decoder's SharedBuffer, so the decoder has to cancel
+// the decode before that goes away.
+class ImageDecoderQt::AsyncDecode {
+public:
+    AsyncDecode(const QByteArray& data, const QByteArray& format, const QSize& scaledSize)
+        : m_data(data)
+        , m_format(format)
+        , m_scaledSize(scaledSize)
+        , m_state(Pending)
+        , m_duration(0)
+    {
+    }
+
+    void run()
+    {
+        if (claim())
+            decode();
+    }
+
+    // Drops the decode if no thread has started it yet, or waits for it to finish.
+    void cancel()
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_state == Pending)
+            m_state = Cancelled;
+        while (m_state == Running)
+            m_finished.wait(&m_mutex);
+    }
+
+    void waitForResult()
+    {
+        if (claim()) {
+            decode();
+            return;
+        }
+        QMutexLocker locker(&m_mutex);
+        while (m_state != Finished)
+            m_finished.wait(&m_mutex);
+    }
+
+    const QImage& image() const { return m_image; }
+    const QRect& frameRect() const { return m_frameRect; }
+    int duration() const { return m_duration; }
+
+private:
+    enum State { Pending, Running, Finished, Cancelled };
+
+    bool claim()
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_state != Pending)
+            return false;
+        m_state = Running;
+        return true;
+    }
+
+    void decode()
+    {
+        QBuffer buffer(&m_data);
+        buffer.open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+        QImageReader reader(&buffer, m_format);
+        reader.setQuality(49);
+        if (m_scaledSize.isValid())
+            reader.setScaledSize(m_scaledSize);
+        m_image = reader.read();
+        m_frameRect = reader.currentImageRect();
+        m_duration = reader.nextImageDelay();
+        buffer.close();
+        m_data.clear();
+
+        QMutexLocker locker(&m_mutex);
+        m_state = Finished;
+        m_finished.wakeAll();
+    }
+
+    QByteArray m_data;
+    QByteArray m_format;
+    QSize m_scaledSize;
+
+    QMutex m_mutex;
+    QWaitCondition m_finished;
+    State m_state;
+
+    QImage m_image;
+    QRect m_frameRect;
+    int m_duration;
+};
+
+// Keeps the decode alive while it is queued, even once its decoder is gone.
+class ImageDecoderQt::AsyncDecodeRunnable : public QRunnable {
+public:
+    AsyncDecodeRunnable(const QSharedPointer<AsyncDecode>& decode)
+        : m_decode(decode)
+    {
+    }
+
+    virtual void run() { m_decode->run(); }
+
+private:
+    QSharedPointer<AsyncDecode> m_decode;
+};
+
+static int s_decodingThreadCount = -1;
+static qint64 s_maxDecodedImageArea = 0;
+
+static QThreadPool* decodingThreadPool()
+{
+    static QThreadPool* pool = 0;
+    if (!pool) {
+        pool = new QThreadPool;
+        pool->setMaxThreadCount(ImageDecoderQt::decodingThreadCount());
+    }
+    return pool;
+}
+
+void ImageDecoderQt::setDecodingThreadCount(int count)
+{
+    s_decodingThreadCount = qMax(count, 0);
+    if (s_decodingThreadCount)
+        decodingThreadPool()->setMaxThreadCount(s_decodingThreadCount);
+}
+
+int ImageDecoderQt::decodingThreadCount()
+{
+    if (s_decodingThreadCount < 0)
+        s_decodingThreadCount = QThread::idealThreadCount() > 0 ? QThread::idealThreadCount() : 1;
+    return s_decodingThreadCount;
+}
+
+void ImageDecoderQt::setMaxDecodedImageArea(qint64 area)
+{
+    s_maxDecodedImageArea = qMax(area, Q_INT64_C(0));
+}
+
+qint64 ImageDecoderQt::maxDecodedImageArea()
+{
+    return s_maxDecodedImageArea;
+}
+
 ImageDecoder* ImageDecoder::create(const SharedBuffer& data, ImageSource::AlphaOption alphaOption, ImageSource::GammaAndColorProfileOption gammaAndColorProfileOption)
 {
     // We need at least 4 bytes to figure out what kind of image we're dealing with.
@@ -54,6 +202,8 @@ ImageDecoderQt::ImageDecoderQt(ImageSource::AlphaOption alphaOption, ImageSource
 
 ImageDecoderQt::~ImageDecoderQt()
 {
+    if (m_asyncDecode)
+        m_asyncDecode->cancel();
 }
 
 void ImageDecoderQt::setData(SharedBuffer* data, bool allDataReceived)
@@ -65,6 +215,9 @@ void ImageDecoderQt::setData(SharedBuffer* data, bool allDataReceived)
     if (!allDataReceived)
         return;
 
+    // The data is read in place by a decode ahead.
+    ASSERT(!m_asyncDecode);
+
     // Cache our own new data.
     ImageDecoder::setData(data, allDataReceived);
 
@@ -146,6 +299,8 @@ ImageFrame* ImageDecoderQt::frameBufferAtIndex(size_t index)
         return 0;
 
     ImageFrame& frame = m_frameBufferCache[index];
+    if (frame.status() != ImageFrame::FrameComplete && m_asyncDecode)
+        internalHandleAsyncDecode();
     if (frame.status() != ImageFrame::FrameComplete && m_reader)
         internalReadImage(index);
     return &frame;
@@ -178,6 +333,10 @@ void ImageDecoderQt::internalReadImage(size_t frameIndex)
     else if (frameIndex) {
         setFailed();
         return clearPointers();
+    } else {
+        QSize scaledSize = scaledDecodingSize();
+        if (scaledSize.isValid())
+            m_reader->setScaledSize(scaledSize);
     }
 
     if (!internalHandleCurrentImage(frameIndex))
@@ -212,6 +371,72 @@ bool ImageDecoderQt::internalHandleCurrentImage(size_t frameIndex)
     return true;
 }
 
+// The size to decode a still image to, to keep it under the maximum decoded area but
+// no smaller than it has been drawn. For JPEG, QImageReader then has libjpeg scale the
+// image down while decoding it.
+QSize ImageDecoderQt::scaledDecodingSize() const
+{
+    if (!s_maxDecodedImageArea || !ImageDecoder::isSizeAvailable())
+        return QSize();
+
+    IntSize imageSize = size();
+    qint64 area = static_cast<qint64>(imageSize.width()) * imageSize.height();
+    if (area <= s_maxDecodedImageArea)
+        return QSize();
+
+    double scale = sqrt(static_cast<double>(s_maxDecodedImageArea) / area);
+    scale = qMax(scale, static_cast<double>(m_minimumDecodedSize.width()) / imageSize.width());
+    scale = qMax(scale, static_cast<double>(m_minimumDecodedSize.height()) / imageSize.height());
+    if (scale >= 1)
+        return QSize();
+    return QSize(qMax(1, static_cast<int>(imageSize.width() * scale)), qMax(1, static_cast<int>(imageSize.height() * scale)));
+}
+
+IntSize ImageDecoderQt::decodedFrameSizeAtIndex(size_t index) const
+{
+    if (index < m_frameBufferCache.size() && m_frameBufferCache[index].status() == ImageFrame::FrameComplete)
+        return IntSize(m_frameBufferCache[index].width(), m_frameBufferCache[index].height());
+
+    // Not decoded yet: still images will be scaled down, see internalReadImage().
+    if (!index && m_reader && !m_reader->supportsAnimation()) {
+        QSize scaledSize = scaledDecodingSize();
+        if (scaledSize.isValid())
+            return IntSize(scaledSize.width(), scaledSize.height());
+    }
+    return frameSizeAtIndex(index);
+}
+
+bool ImageDecoderQt::startDecodingAhead()
+{
+    // Animated images are decoded frame by frame as they are shown. Once decoded,
+    // the reader is gone.
+    if (m_asyncDecode || !m_reader || !decodingThreadCount() || m_format.isEmpty() || m_reader->supportsAnimation() || !isSizeAvailable())
+        return false;
+
+    QByteArray imageData = QByteArray::fromRawData(m_data->data(), m_data->size());
+    m_asyncDecode = QSharedPointer<AsyncDecode>(new AsyncDecode(imageData, m_format, scaledDecodingSize()));
+    decodingThreadPool()->start(new AsyncDecodeRunnable(m_asyncDecode));
+    return true;
+}
+
+bool ImageDecoderQt::internalHandleAsyncDecode()
+{
+    QSharedPointer<AsyncDecode> decode = m_asyncDecode;
+    m_asyncDecode.clear();
+    decode->waitForResult();
+    // Let the synchronous path fail the usual way.
+    if (decode->image().isNull())
+        return false;
+
+    ImageFrame* const buffer = &m_frameBufferCache[0];
+    buffer->setOriginalFrameRect(decode->frameRect());
+    buffer->setStatus(ImageFrame::FrameComplete);
+    buffer->setDuration(decode->duration());
+    buffer->setPixmap(QPixmap::fromImage(decode->image()));
+    clearPointers();
+    return true;
+}
+
 // The QImageIOHandler is not able to tell us how many frames
 // we have and we need to parse every image. We do this by
 // increasing the m_frameBufferCache by one and try to parse
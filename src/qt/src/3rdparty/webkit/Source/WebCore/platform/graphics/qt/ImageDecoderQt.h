@@ -33,6 +33,7 @@
 #include <QtCore/QList>
 #include <QtCore/QHash>
 #include <QtCore/QBuffer>
+#include <QtCore/QSharedPointer>
 #include <wtf/OwnPtr.h>
 #include <wtf/PassOwnPtr.h>
 
@@ -50,12 +51,29 @@ public:
     virtual size_t frameCount();
     virtual int repetitionCount() const;
     virtual ImageFrame* frameBufferAtIndex(size_t index);
+    virtual bool startDecodingAhead();
 
     virtual String filenameExtension() const;
 
+    virtual IntSize decodedFrameSizeAtIndex(size_t) const;
+
     virtual void clearFrameBufferCache(size_t clearBeforeFrame);
 
+    // Still images about to be painted (see startDecodingAhead()) are decoded by this
+    // many threads, instead of when they are painted. 0 turns this off.
+    static void setDecodingThreadCount(int);
+    static int decodingThreadCount();
+
+    // Still images of more pixels than this are decoded scaled down to about this
+    // many pixels, but no smaller than the largest size they have been drawn at, and
+    // scaled back up when painted. 0, the default, means no limit.
+    static void setMaxDecodedImageArea(qint64);
+    static qint64 maxDecodedImageArea();
+
 private:
+    class AsyncDecode;
+    class AsyncDecodeRunnable;
+
     ImageDecoderQt(const ImageDecoderQt&);
     ImageDecoderQt &operator=(const ImageDecoderQt&);
 
@@ -63,6 +81,8 @@ private:
     void internalDecodeSize();
     void internalReadImage(size_t);
     bool internalHandleCurrentImage(size_t);
+    QSize scaledDecodingSize() const;
+    bool internalHandleAsyncDecode();
     void forceLoadEverything();
     void clearPointers();
 
@@ -70,6 +90,7 @@ private:
     QByteArray m_format;
     OwnPtr<QBuffer> m_buffer;
     OwnPtr<QImageReader> m_reader;
+    QSharedPointer<AsyncDecode> m_asyncDecode;
     mutable int m_repetitionCount;
 };
 
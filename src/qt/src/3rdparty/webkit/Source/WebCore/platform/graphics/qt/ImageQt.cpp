@@ -91,6 +91,15 @@ bool FrameData::clear(bool clearMetadata)
     return false;
 }
 
+// The size in device pixels of the whole image drawn through this transform, up to
+// the image's own size.
+static IntSize drawnImageSize(const IntSize& imageSize, const QTransform& transform)
+{
+    qreal scaleX = qMin(qreal(sqrt(transform.m11() * transform.m11() + transform.m12() * transform.m12())), qreal(1));
+    qreal scaleY = qMin(qreal(sqrt(transform.m21() * transform.m21() + transform.m22() * transform.m22())), qreal(1));
+    return IntSize(qRound(imageSize.width() * scaleX), qRound(imageSize.height() * scaleY));
+}
+
 
 // ================================================
 // Image Class
@@ -104,6 +113,8 @@ PassRefPtr<Image> Image::loadPlatformResource(const char* name)
 void Image::drawPattern(GraphicsContext* ctxt, const FloatRect& tileRect, const AffineTransform& patternTransform,
                         const FloatPoint& phase, ColorSpace, CompositeOperator op, const FloatRect& destRect)
 {
+    willDrawAtSize(drawnImageSize(size(), QTransform(patternTransform) * ctxt->platformContext()->combinedTransform()));
+
     QPixmap* framePixmap = nativeImageForCurrentFrame();
     if (!framePixmap) // If it's too early we won't have an image yet.
         return;
@@ -115,6 +126,18 @@ void Image::drawPattern(GraphicsContext* ctxt, const FloatRect& tileRect, const
         return;
 
     QPixmap pixmap = *framePixmap;
+    QTransform transform(patternTransform);
+
+    // Images decoded scaled down are drawn scaled back up to their size.
+    if (pixmap.size() != QSize(size())) {
+        qreal scaleX = qreal(pixmap.width()) / width();
+        qreal scaleY = qreal(pixmap.height()) / height();
+        tr = QRectF(tr.x() * scaleX, tr.y() * scaleY, tr.width() * scaleX, tr.height() * scaleY).toRect();
+        if (tr.isEmpty())
+            return;
+        transform = QTransform::fromScale(1 / scaleX, 1 / scaleY) * transform;
+    }
+
     if (tr.x() || tr.y() || tr.width() != pixmap.width() || tr.height() != pixmap.height())
         pixmap = pixmap.copy(tr);
 
@@ -123,7 +146,6 @@ void Image::drawPattern(GraphicsContext* ctxt, const FloatRect& tileRect, const
     ctxt->setCompositeOperation(!pixmap.hasAlpha() && op == CompositeSourceOver ? CompositeCopy : op);
 
     QPainter* p = ctxt->platformContext();
-    QTransform transform(patternTransform);
 
     // If this would draw more than one scaled tile, we scale the pixmap first and then use the result to draw.
     if (transform.type() == QTransform::TxScale) {
@@ -175,6 +197,8 @@ BitmapImage::BitmapImage(QPixmap* pixmap, ImageObserver* observer)
     , m_haveSize(true)
     , m_sizeAvailable(true)
     , m_decodedSize(0)
+    , m_decodingAheadSize(0)
+    , m_decodeAheadRequested(false)
     , m_haveFrameCount(true)
     , m_frameCount(1)
 {
@@ -187,6 +211,7 @@ BitmapImage::BitmapImage(QPixmap* pixmap, ImageObserver* observer)
 
     m_frames.grow(1);
     m_frames[0].m_frame = pixmap;
+    m_frames[0].m_frameBytes = m_decodedSize;
     m_frames[0].m_hasAlpha = pixmap->hasAlpha();
     m_frames[0].m_haveMetadata = true;
     checkForSolidColor();
@@ -212,6 +237,10 @@ void BitmapImage::draw(GraphicsContext* ctxt, const FloatRect& dst,
     if (normalizedSrc.isEmpty() || normalizedDst.isEmpty())
         return;
 
+    // Images decoded scaled down are decoded again if drawn larger than that.
+    QTransform drawTransform = QTransform::fromScale(normalizedDst.width() / normalizedSrc.width(), normalizedDst.height() / normalizedSrc.height());
+    willDrawAtSize(drawnImageSize(size(), drawTransform * ctxt->platformContext()->combinedTransform()));
+
     QPixmap* image = nativeImageForCurrentFrame();
     if (!image)
         return;
@@ -221,6 +250,13 @@ void BitmapImage::draw(GraphicsContext* ctxt, const FloatRect& dst,
         return;
     }
 
+    // Images decoded scaled down are drawn scaled back up to their size.
+    if (image->size() != QSize(size())) {
+        qreal scaleX = qreal(image->width()) / width();
+        qreal scaleY = qreal(image->height()) / height();
+        normalizedSrc = QRectF(normalizedSrc.x() * scaleX, normalizedSrc.y() * scaleY, normalizedSrc.width() * scaleX, normalizedSrc.height() * scaleY);
+    }
+
     CompositeOperator previousOperator = ctxt->compositeOperation();
     ctxt->setCompositeOperation(!image->hasAlpha() && op == CompositeSourceOver ? CompositeCopy : op);
 
@@ -39,7 +39,12 @@ QBrush Pattern::createPlatformPattern(const AffineTransform&) const
 
     // Qt merges patter space and user space itself
     QBrush brush(*pixmap);
-    brush.setTransform(m_patternSpaceTransformation);
+    QTransform transform(m_patternSpaceTransformation);
+    // Images decoded scaled down are drawn scaled back up to their size.
+    IntSize tileSize = tileImage()->size();
+    if (pixmap->size() != QSize(tileSize) && !tileSize.isEmpty())
+        transform = QTransform::fromScale(qreal(tileSize.width()) / pixmap->width(), qreal(tileSize.height()) / pixmap->height()) * transform;
+    brush.setTransform(transform);
 
     return brush;
 }
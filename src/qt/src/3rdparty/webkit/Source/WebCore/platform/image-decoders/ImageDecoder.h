@@ -272,6 +272,14 @@ namespace WebCore {
             return size();
         }
 
+        // The size of the frame as decoded, which is what it takes in memory.
+        // This is smaller than frameSizeAtIndex() when the decoder scales the
+        // image down while decoding it.
+        virtual IntSize decodedFrameSizeAtIndex(size_t index) const
+        {
+            return m_scaled ? scaledSize() : frameSizeAtIndex(index);
+        }
+
         // Returns whether the size is legal (i.e. not going to result in
         // overflow elsewhere).  If not, marks decoding as failed.
         virtual bool setSize(unsigned width, unsigned height)
@@ -295,6 +303,14 @@ namespace WebCore {
         // ImageDecoder-owned pointer.
         virtual ImageFrame* frameBufferAtIndex(size_t) = 0;
 
+        // Starts decoding the first frame in the background, for a later
+        // frameBufferAtIndex(0). Returns whether it was started.
+        virtual bool startDecodingAhead() { return false; }
+
+        // Frames that decoders decode scaled down are not made smaller than
+        // this, the largest size the image has been drawn at.
+        void setMinimumDecodedSize(const IntSize& size) { m_minimumDecodedSize = size; }
+
         void setIgnoreGammaAndColorProfile(bool flag) { m_ignoreGammaAndColorProfile = flag; }
         bool ignoresGammaAndColorProfile() const { return m_ignoreGammaAndColorProfile; }
 
@@ -335,6 +351,7 @@ namespace WebCore {
         Vector<int> m_scaledRows;
         bool m_premultiplyAlpha;
         bool m_ignoreGammaAndColorProfile;
+        IntSize m_minimumDecodedSize;
 
     private:
         // Some code paths compute the size of the image as "width * height * 4"
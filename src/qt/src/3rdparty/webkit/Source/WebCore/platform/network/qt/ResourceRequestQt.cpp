@@ -43,6 +43,21 @@ unsigned initializeMaximumHTTPConnectionCountPerHost()
 #endif
 }
 
+// Lets Qt send the important requests first among those queued for a
+// connection to the same host.
+static QNetworkRequest::Priority toQNetworkRequestPriority(ResourceLoadPriority priority)
+{
+    switch (priority) {
+    case ResourceLoadPriorityVeryLow:
+    case ResourceLoadPriorityLow:
+        return QNetworkRequest::LowPriority;
+    case ResourceLoadPriorityHigh:
+        return QNetworkRequest::HighPriority;
+    default:
+        return QNetworkRequest::NormalPriority;
+    }
+}
+
 QNetworkRequest ResourceRequest::toNetworkRequest(QObject* originatingFrame) const
 {
     QNetworkRequest request;
@@ -83,6 +98,8 @@ QNetworkRequest ResourceRequest::toNetworkRequest(QObject* originatingFrame) con
         break;
     }
 
+    request.setPriority(toQNetworkRequestPriority(priority()));
+
     if (!allowCookies()) {
         request.setAttribute(QNetworkRequest::CookieLoadControlAttribute, QNetworkRequest::Manual);
         request.setAttribute(QNetworkRequest::CookieSaveControlAttribute, QNetworkRequest::Manual);
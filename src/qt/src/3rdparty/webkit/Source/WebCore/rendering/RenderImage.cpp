@@ -139,6 +139,11 @@ void RenderImage::imageChanged(WrappedImagePtr newImage, const IntRect* rect)
     if (newImage != m_imageResource->imagePtr() || !newImage)
         return;
 
+    // A rendered image is going to be painted: its decoding can start now.
+    CachedImage* cachedImage = m_imageResource->cachedImage();
+    if (cachedImage && !cachedImage->errorOccurred())
+        cachedImage->image()->willDraw();
+
     bool imageSizeChanged = false;
 
     // Set image dimensions, taking into account the size of the alt text.
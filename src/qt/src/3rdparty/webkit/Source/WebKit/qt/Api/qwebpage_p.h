@@ -24,6 +24,7 @@
 #include <qbasictimer.h>
 #include <qnetworkproxy.h>
 #include <qpointer.h>
+#include <qregexp.h>
 #include <qevent.h>
 #include <qgraphicssceneevent.h>
 
@@ -34,6 +35,7 @@
 #include "IntPoint.h"
 #include "KURL.h"
 #include "PlatformString.h"
+#include "ResourceLoadPriority.h"
 
 #include <wtf/OwnPtr.h>
 #include <wtf/RefPtr.h>
@@ -211,6 +213,14 @@ public:
     bool inspectorIsInternalOnly; // True if created through the Inspect context menu action
     Qt::DropAction m_lastDropAction;
 
+    // Overrides of the priority subresources are loaded with, see FrameLoaderClientQt::resourceLoadPriority.
+    struct ResourceLoadPriorityRule {
+        QRegExp urlPattern; // Matches any URL when empty
+        int targetType; // A WebCore::ResourceRequest::TargetType, or -1 for any type
+        WebCore::ResourceLoadPriority priority;
+    };
+    QList<ResourceLoadPriorityRule> resourceLoadPriorityRules;
+
     static bool drtRun;
 };
 
@@ -28,6 +28,8 @@
 #endif
 #include "ApplicationCacheStorage.h"
 #include "CSSComputedStyleDeclaration.h"
+#include "CachedResourceLoader.h"
+#include "CachedScript.h"
 #include "ChromeClientQt.h"
 #include "ContainerNode.h"
 #include "ContextMenu.h"
@@ -35,11 +37,13 @@
 #include "ContextMenuController.h"
 #include "DeviceOrientation.h"
 #include "DeviceOrientationClientMockQt.h"
+#include "Document.h"
 #include "DocumentLoader.h"
 #include "Editor.h"
 #include "EditorClientQt.h"
 #include "Element.h"
 #include "FocusController.h"
+#include "FontCache.h"
 #include "Frame.h"
 #include "FrameLoaderClientQt.h"
 #include "FrameView.h"
@@ -54,19 +58,24 @@
 #include "GeolocationController.h"
 #include "GeolocationError.h"
 #include "GeolocationPosition.h"
+#include "GlyphPageTreeNode.h"
 #include "HistoryItem.h"
 #include "HTMLInputElement.h"
+#include "ImageDecoderQt.h"
 #include "InputElement.h"
 #include "InspectorController.h"
+#include "MemoryCache.h"
 #include "NodeList.h"
 #include "NotificationPresenterClientQt.h"
 #include "Page.h"
+#include "PageCache.h"
 #include "PageGroup.h"
 #include "PluginDatabase.h"
 #include "PositionError.h"
 #include "PrintContext.h"
 #include "RenderListItem.h"
 #include "RenderTreeAsText.h"
+#include "ResourceRequest.h"
 #include "ShadowRoot.h"
 #include "ScriptController.h"
 #include "ScriptValue.h"
@@ -77,9 +86,16 @@
 #include "SVGSMILElement.h"
 #endif
 #include "TextIterator.h"
+#include "Timer.h"
 #include "WebCoreTestSupport.h"
 #include "WorkerThread.h"
 #include <wtf/CurrentTime.h>
+#if USE(JSC)
+#include <profiler/Profiler.h>
+#include <profiler/SamplingProfiler.h>
+#include <runtime/MemoryStatistics.h>
+#include <runtime/RegExpCache.h>
+#endif
 
 #include "qwebelement.h"
 #include "qwebframe.h"
@@ -392,6 +408,344 @@ int DumpRenderTreeSupportQt::javaScriptObjectsCount()
 #endif
 }
 
+// Sizes are in bytes, collection times in milliseconds.
+QVariantMap DumpRenderTreeSupportQt::javaScriptHeapStatistics()
+{
+    QVariantMap statistics;
+#if USE(JSC)
+    JSC::JSLock lock(JSC::SilenceAssertionsOnly);
+    JSC::Heap& heap = JSDOMWindowBase::commonJSGlobalData()->heap;
+    statistics.insert("size", static_cast<qulonglong>(heap.size()));
+    statistics.insert("capacity", static_cast<qulonglong>(heap.capacity()));
+    statistics.insert("objectCount", static_cast<qulonglong>(heap.objectCount()));
+    statistics.insert("collections", static_cast<qulonglong>(heap.collectionCount()));
+    statistics.insert("minorCollections", static_cast<qulonglong>(heap.minorCollectionCount()));
+    statistics.insert("generational", heap.isGenerational());
+    statistics.insert("totalCollectionTime", heap.totalCollectionTime() * 1000);
+    statistics.insert("lastCollectionTime", heap.lastCollectionTime() * 1000);
+    statistics.insert("markingThreads", heap.markingThreadCount());
+    statistics.insert("totalMarkingTime", heap.totalMarkingTime() * 1000);
+    statistics.insert("lastMarkingTime", heap.lastMarkingTime() * 1000);
+#endif
+    return statistics;
+}
+
+bool DumpRenderTreeSupportQt::javaScriptDFGJITAvailable()
+{
+#if USE(JSC) && ENABLE(DFG_JIT)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool DumpRenderTreeSupportQt::javaScriptParallelMarkingAvailable()
+{
+#if USE(JSC) && ENABLE(PARALLEL_GC)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool DumpRenderTreeSupportQt::javaScriptGenerationalGCAvailable()
+{
+#if USE(JSC) && ENABLE(GGC)
+    return true;
+#else
+    return false;
+#endif
+}
+
+QVariantMap DumpRenderTreeSupportQt::javaScriptRegExpStatistics()
+{
+    QVariantMap statistics;
+#if USE(JSC)
+    JSC::JSLock lock(JSC::SilenceAssertionsOnly);
+    JSC::RegExpCache* cache = JSDOMWindowBase::commonJSGlobalData()->regExpCache();
+    statistics.insert("cacheCapacity", cache->capacity());
+    statistics.insert("cacheMaxPatternLength", cache->maxPatternLength());
+    statistics.insert("cacheSize", cache->size());
+    statistics.insert("cacheHits", static_cast<qulonglong>(cache->hitCount()));
+    statistics.insert("cacheMisses", static_cast<qulonglong>(cache->missCount()));
+    statistics.insert("uncacheable", static_cast<qulonglong>(cache->uncacheableCount()));
+    qulonglong lookups = cache->hitCount() + cache->missCount();
+    statistics.insert("cacheHitRate", lookups ? static_cast<double>(cache->hitCount()) / lookups : 0.0);
+    statistics.insert("interpreterFallbacks", static_cast<qulonglong>(cache->interpreterFallbackCount()));
+
+    // The patterns Yarr JIT could not compile, as /pattern/flags, with how many times each was compiled.
+    QVariantMap interpretedPatterns;
+    const JSC::RegExpCache::InterpretedPatternMap& patterns = cache->interpretedPatterns();
+    JSC::RegExpCache::InterpretedPatternMap::const_iterator end = patterns.end();
+    for (JSC::RegExpCache::InterpretedPatternMap::const_iterator it = patterns.begin(); it != end; ++it) {
+        QString flags;
+        if (it->first.flagsValue & JSC::FlagGlobal)
+            flags += QLatin1Char('g');
+        if (it->first.flagsValue & JSC::FlagIgnoreCase)
+            flags += QLatin1Char('i');
+        if (it->first.flagsValue & JSC::FlagMultiline)
+            flags += QLatin1Char('m');
+        QString pattern = QLatin1Char('/') + QString(String(it->first.pattern.get())) + QLatin1Char('/') + flags;
+        interpretedPatterns.insert(pattern, it->second);
+    }
+    statistics.insert("interpretedPatterns", interpretedPatterns);
+#endif
+    return statistics;
+}
+
+static QVariantMap toVariantMap(const MemoryCache::TypeStatistic& statistic)
+{
+    QVariantMap map;
+    map.insert("count", statistic.count);
+    map.insert("size", statistic.size);
+    map.insert("liveSize", statistic.liveSize);
+    map.insert("decodedSize", statistic.decodedSize);
+    return map;
+}
+
+// Where the memory of the process goes, in bytes: shared by all the pages.
+QVariantMap DumpRenderTreeSupportQt::memoryStatistics()
+{
+    QVariantMap statistics;
+#if USE(JSC)
+    JSC::JSLock lock(JSC::SilenceAssertionsOnly);
+    JSC::Heap& heap = JSDOMWindowBase::commonJSGlobalData()->heap;
+    QVariantMap jsHeap;
+    jsHeap.insert("size", static_cast<qulonglong>(heap.size()));
+    jsHeap.insert("capacity", static_cast<qulonglong>(heap.capacity()));
+    jsHeap.insert("blocks", static_cast<qulonglong>(heap.blockCount()));
+    jsHeap.insert("extraCost", static_cast<qulonglong>(heap.extraCost()));
+    jsHeap.insert("objectCount", static_cast<qulonglong>(heap.objectCount()));
+    statistics.insert("jsHeap", jsHeap);
+
+    JSC::GlobalMemoryStatistics globalStatistics = JSC::globalMemoryStatistics();
+    statistics.insert("jitCode", static_cast<qulonglong>(globalStatistics.JITBytes));
+    statistics.insert("jsStack", static_cast<qulonglong>(globalStatistics.stackBytes));
+#endif
+
+    MemoryCache::Statistics cacheStatistics = memoryCache()->getStatistics();
+    QVariantMap cache;
+    cache.insert("capacity", memoryCache()->capacity());
+    cache.insert("minDeadCapacity", memoryCache()->minDeadCapacity());
+    cache.insert("maxDeadCapacity", memoryCache()->maxDeadCapacity());
+    cache.insert("liveSize", memoryCache()->liveSize());
+    cache.insert("deadSize", memoryCache()->deadSize());
+    qulonglong hits = memoryCache()->requestCount(MemoryCache::RequestServedFromCache);
+    qulonglong revalidations = memoryCache()->requestCount(MemoryCache::RequestRevalidated);
+    qulonglong loads = memoryCache()->requestCount(MemoryCache::RequestLoaded);
+    cache.insert("hits", hits);
+    cache.insert("revalidations", revalidations);
+    cache.insert("misses", loads);
+    cache.insert("hitRate", hits + revalidations + loads ? static_cast<double>(hits) / (hits + revalidations + loads) : 0.0);
+    cache.insert("images", toVariantMap(cacheStatistics.images));
+    cache.insert("styleSheets", toVariantMap(cacheStatistics.cssStyleSheets));
+    cache.insert("scripts", toVariantMap(cacheStatistics.scripts));
+#if ENABLE(XSLT)
+    cache.insert("xslStyleSheets", toVariantMap(cacheStatistics.xslStyleSheets));
+#endif
+    cache.insert("fonts", toVariantMap(cacheStatistics.fonts));
+    statistics.insert("memoryCache", cache);
+
+    QVariantMap pages;
+    pages.insert("capacity", pageCache()->capacity());
+    pages.insert("count", pageCache()->pageCount());
+    statistics.insert("pageCache", pages);
+
+    QVariantMap fonts;
+    fonts.insert("fontData", static_cast<qulonglong>(fontCache()->fontDataCount()));
+    fonts.insert("inactiveFontData", static_cast<qulonglong>(fontCache()->inactiveFontDataCount()));
+    fonts.insert("glyphPages", static_cast<qulonglong>(GlyphPageTreeNode::treeGlyphPageCount()));
+    statistics.insert("fontCache", fonts);
+    return statistics;
+}
+
+// Collects garbage first, so that only live objects are counted.
+QVariantMap DumpRenderTreeSupportQt::javaScriptObjectTypeCounts()
+{
+    QVariantMap counts;
+#if USE(JSC)
+    JSC::JSLock lock(JSC::SilenceAssertionsOnly);
+    JSC::Heap& heap = JSDOMWindowBase::commonJSGlobalData()->heap;
+    heap.collectAllGarbage();
+    OwnPtr<JSC::TypeCountSet> typeCounts = heap.objectTypeCounts();
+    JSC::TypeCountSet::const_iterator end = typeCounts->end();
+    for (JSC::TypeCountSet::const_iterator it = typeCounts->begin(); it != end; ++it)
+        counts.insert(QString::fromLatin1(it->first), it->second);
+#endif
+    return counts;
+}
+
+// What the documents of a frame and of its subframes hold on to, in bytes.
+QVariantMap DumpRenderTreeSupportQt::frameMemoryStatistics(QWebFrame* frame)
+{
+    Frame* mainFrame = QWebFramePrivate::core(frame);
+    int frameCount = 0;
+    int nodeCount = 0;
+    MemoryCache::TypeStatistic images;
+    MemoryCache::TypeStatistic others;
+    for (Frame* coreFrame = mainFrame; coreFrame; coreFrame = coreFrame->tree()->traverseNext(mainFrame)) {
+        Document* document = coreFrame->document();
+        if (!document)
+            continue;
+        ++frameCount;
+        for (Node* node = document; node; node = node->traverseNextNode())
+            ++nodeCount;
+
+        const CachedResourceLoader::DocumentResourceMap& resources = document->cachedResourceLoader()->allCachedResources();
+        CachedResourceLoader::DocumentResourceMap::const_iterator end = resources.end();
+        for (CachedResourceLoader::DocumentResourceMap::const_iterator it = resources.begin(); it != end; ++it) {
+            CachedResource* resource = it->second.get();
+            if (resource)
+                (resource->type() == CachedResource::ImageResource ? images : others).addResource(resource);
+        }
+    }
+
+    QVariantMap statistics;
+    statistics.insert("frames", frameCount);
+    statistics.insert("domNodes", nodeCount);
+    statistics.insert("images", toVariantMap(images));
+    statistics.insert("otherResources", toVariantMap(others));
+    return statistics;
+}
+
+#if USE(JSC)
+// Throws away the code of all JavaScript functions once no script runs, so that they
+// are compiled again with or without the profiler hooks.
+class JavaScriptRecompiler {
+public:
+    static JavaScriptRecompiler& shared()
+    {
+        DEFINE_STATIC_LOCAL(JavaScriptRecompiler, recompiler, ());
+        return recompiler;
+    }
+
+    void recompileSoon()
+    {
+        if (!m_timer.isActive())
+            m_timer.startOneShot(0);
+    }
+
+private:
+    JavaScriptRecompiler()
+        : m_timer(this, &JavaScriptRecompiler::recompile)
+    {
+    }
+
+    void recompile(Timer<JavaScriptRecompiler>*)
+    {
+        JSC::JSLock lock(JSC::SilenceAssertionsOnly);
+        JSC::JSGlobalData* globalData = JSDOMWindowBase::commonJSGlobalData();
+        if (globalData->dynamicGlobalObject)
+            recompileSoon();
+        else
+            globalData->recompileAllJSFunctions();
+    }
+
+    Timer<JavaScriptRecompiler> m_timer;
+};
+
+static QString toQString(const JSC::UString& string)
+{
+    return QString(reinterpret_cast<const QChar*>(string.characters()), string.length());
+}
+#endif
+
+bool DumpRenderTreeSupportQt::startJavaScriptSampling(QWebFrame* frame, int intervalInMicroseconds)
+{
+#if USE(JSC)
+    JSC::JSLock lock(JSC::SilenceAssertionsOnly);
+    JSDOMWindow* window = toJSDOMWindow(QWebFramePrivate::core(frame), mainThreadNormalWorld());
+    if (!window || !JSC::Profiler::profiler()->startSampling(window, qMax(intervalInMicroseconds, 100) / 1000000.0))
+        return false;
+    JavaScriptRecompiler::shared().recompileSoon();
+    return true;
+#else
+    return false;
+#endif
+}
+
+// The profile is in the format of Chrome's .cpuprofile files, with times in microseconds.
+QVariantMap DumpRenderTreeSupportQt::stopJavaScriptSampling(QWebFrame* frame)
+{
+    QVariantMap profile;
+#if USE(JSC)
+    JSC::JSLock lock(JSC::SilenceAssertionsOnly);
+    JSDOMWindow* window = toJSDOMWindow(QWebFramePrivate::core(frame), mainThreadNormalWorld());
+    if (!window)
+        return profile;
+    OwnPtr<JSC::SamplingProfiler> samplingProfiler = JSC::Profiler::profiler()->stopSampling(window);
+    if (!samplingProfiler)
+        return profile;
+    if (!JSC::Profiler::profiler()->isSampling())
+        JavaScriptRecompiler::shared().recompileSoon();
+
+    // Node ids start at 1.
+    QVariantList nodes;
+    const Vector<JSC::SamplingProfiler::Node>& profileNodes = samplingProfiler->nodes();
+    for (size_t i = 0; i < profileNodes.size(); ++i) {
+        const JSC::CallIdentifier& function = samplingProfiler->functions()[profileNodes[i].function];
+        QVariantMap callFrame;
+        callFrame.insert("functionName", toQString(function.m_name));
+        callFrame.insert("scriptId", "0");
+        callFrame.insert("url", toQString(function.m_url));
+        callFrame.insert("lineNumber", static_cast<int>(function.m_lineNumber) - 1);
+        callFrame.insert("columnNumber", -1);
+
+        QVariantList children;
+        for (size_t j = 0; j < profileNodes[i].children.size(); ++j)
+            children.append(profileNodes[i].children[j] + 1);
+
+        QVariantMap node;
+        node.insert("id", static_cast<uint>(i + 1));
+        node.insert("callFrame", callFrame);
+        node.insert("hitCount", profileNodes[i].hitCount);
+        node.insert("children", children);
+        nodes.append(node);
+    }
+
+    QVariantList samples;
+    QVariantList timeDeltas;
+    qlonglong lastTime = static_cast<qlonglong>(samplingProfiler->startTime() * 1000000);
+    for (size_t i = 0; i < samplingProfiler->samples().size(); ++i) {
+        qlonglong time = static_cast<qlonglong>(samplingProfiler->sampleTimes()[i] * 1000000);
+        samples.append(samplingProfiler->samples()[i] + 1);
+        timeDeltas.append(time - lastTime);
+        lastTime = time;
+    }
+
+    profile.insert("nodes", nodes);
+    profile.insert("startTime", static_cast<qlonglong>(samplingProfiler->startTime() * 1000000));
+    profile.insert("endTime", static_cast<qlonglong>(samplingProfiler->endTime() * 1000000));
+    profile.insert("samples", samples);
+    profile.insert("timeDeltas", timeDeltas);
+#endif
+    return profile;
+}
+
+void DumpRenderTreeSupportQt::setScriptParseCacheDirectory(const QString& directory)
+{
+#if USE(JSC)
+    CachedScript::setSourceProviderCacheDirectory(directory);
+#else
+    Q_UNUSED(directory);
+#endif
+}
+
+void DumpRenderTreeSupportQt::pruneMemoryCache(double fraction)
+{
+    memoryCache()->pruneToPercentage(qBound(0.0, fraction, 1.0));
+}
+
+void DumpRenderTreeSupportQt::setImageDecodingThreadCount(int count)
+{
+    ImageDecoderQt::setDecodingThreadCount(count);
+}
+
+void DumpRenderTreeSupportQt::setMaxDecodedImageArea(qint64 area)
+{
+    ImageDecoderQt::setMaxDecodedImageArea(area);
+}
+
 void DumpRenderTreeSupportQt::garbageCollectorCollect()
 {
 #if USE(JSC)
@@ -1046,6 +1400,65 @@ void DumpRenderTreeSupportQt::setMinimumTimerInterval(QWebPage* page, double int
     corePage->settings()->setMinDOMTimerInterval(interval);
 }
 
+void DumpRenderTreeSupportQt::setMaximumRequestsInFlightPerHost(QWebPage* page, int count)
+{
+    Page* corePage = QWebPagePrivate::core(page);
+    if (!corePage)
+        return;
+
+    corePage->settings()->setMaximumRequestsInFlightPerHost(qMax(0, count));
+}
+
+static int toTargetType(const QString& type)
+{
+    if (type.isEmpty())
+        return -1;
+    if (type == "stylesheet")
+        return ResourceRequest::TargetIsStyleSheet;
+    if (type == "script")
+        return ResourceRequest::TargetIsScript;
+    if (type == "font")
+        return ResourceRequest::TargetIsFontResource;
+    if (type == "image")
+        return ResourceRequest::TargetIsImage;
+    if (type == "prefetch")
+        return ResourceRequest::TargetIsPrefetch;
+    return ResourceRequest::TargetIsSubresource;
+}
+
+static ResourceLoadPriority toResourceLoadPriority(const QString& priority)
+{
+    if (priority == "defer" || priority == "veryLow")
+        return ResourceLoadPriorityVeryLow;
+    if (priority == "low")
+        return ResourceLoadPriorityLow;
+    if (priority == "medium")
+        return ResourceLoadPriorityMedium;
+    if (priority == "high")
+        return ResourceLoadPriorityHigh;
+    return ResourceLoadPriorityUnresolved;
+}
+
+// Each rule is a map with an optional "url" regular expression, an optional
+// "type" (stylesheet, script, font, image, prefetch or other) and the
+// "priority" (defer, low, medium or high) matching subresources load with.
+// Rules without a known priority are dropped.
+void DumpRenderTreeSupportQt::setResourceLoadPriorityRules(QWebPage* page, const QVariantList& rules)
+{
+    QWebPagePrivate* pagePrivate = page->handle();
+    pagePrivate->resourceLoadPriorityRules.clear();
+    for (int i = 0; i < rules.size(); ++i) {
+        QVariantMap map = rules.at(i).toMap();
+        QWebPagePrivate::ResourceLoadPriorityRule rule;
+        rule.priority = toResourceLoadPriority(map.value("priority").toString());
+        if (rule.priority == ResourceLoadPriorityUnresolved)
+            continue;
+        rule.urlPattern = QRegExp(map.value("url").toString());
+        rule.targetType = toTargetType(map.value("type").toString());
+        pagePrivate->resourceLoadPriorityRules.append(rule);
+    }
+}
+
 QUrl DumpRenderTreeSupportQt::mediaContentUrlByElementId(QWebFrame* frame, const QString& elementId)
 {
     QUrl res;
@@ -118,6 +118,21 @@ public:
     static void setJavaScriptProfilingEnabled(QWebFrame*, bool enabled);
     static void setValueForUser(const QWebElement&, const QString& value);
     static int javaScriptObjectsCount();
+    static QVariantMap javaScriptHeapStatistics();
+    static QVariantMap javaScriptRegExpStatistics();
+    // Whether JavaScriptCore was built with these (see wtf/Platform.h)
+    static bool javaScriptDFGJITAvailable();
+    static bool javaScriptParallelMarkingAvailable();
+    static bool javaScriptGenerationalGCAvailable();
+    static QVariantMap memoryStatistics();
+    static QVariantMap javaScriptObjectTypeCounts();
+    static QVariantMap frameMemoryStatistics(QWebFrame*);
+    static bool startJavaScriptSampling(QWebFrame*, int intervalInMicroseconds);
+    static QVariantMap stopJavaScriptSampling(QWebFrame*);
+    static void setScriptParseCacheDirectory(const QString& directory);
+    static void pruneMemoryCache(double fraction);
+    static void setImageDecodingThreadCount(int count);
+    static void setMaxDecodedImageArea(qint64 area);
     static void clearScriptWorlds();
     static void evaluateScriptInIsolatedWorld(QWebFrame* frame, int worldID, const QString& script);
 
@@ -207,6 +222,8 @@ public:
 
     static double defaultMinimumTimerInterval(); // Not really tied to WebView
     static void setMinimumTimerInterval(QWebPage*, double);
+    static void setMaximumRequestsInFlightPerHost(QWebPage*, int count);
+    static void setResourceLoadPriorityRules(QWebPage*, const QVariantList& rules);
 
     static QUrl mediaContentUrlByElementId(QWebFrame*, const QString& elementId);
     static void setAlternateHtml(QWebFrame*, const QString& html, const QUrl& baseUrl, const QUrl& failingUrl);
@@ -1020,6 +1020,28 @@ void FrameLoaderClientQt::assignIdentifierToInitialRequest(unsigned long identif
         dumpAssignedUrls[identifier] = drtDescriptionSuitableForTestResult(request.url());
 }
 
+// The first of the page's rules matching the type and URL of the request decides its priority.
+WebCore::ResourceLoadPriority FrameLoaderClientQt::resourceLoadPriority(const WebCore::ResourceRequest& request, WebCore::ResourceLoadPriority defaultPriority)
+{
+    if (!m_webFrame)
+        return defaultPriority;
+
+    const QList<QWebPagePrivate::ResourceLoadPriorityRule>& rules = m_webFrame->page()->d->resourceLoadPriorityRules;
+    if (rules.isEmpty())
+        return defaultPriority;
+
+    QString url = request.url().string();
+    for (int i = 0; i < rules.size(); ++i) {
+        const QWebPagePrivate::ResourceLoadPriorityRule& rule = rules.at(i);
+        if (rule.targetType != -1 && rule.targetType != request.targetType())
+            continue;
+        if (!rule.urlPattern.isEmpty() && rule.urlPattern.indexIn(url) == -1)
+            continue;
+        return rule.priority;
+    }
+    return defaultPriority;
+}
+
 void FrameLoaderClientQt::dispatchWillSendRequest(WebCore::DocumentLoader*, unsigned long identifier, WebCore::ResourceRequest& newRequest, const WebCore::ResourceResponse& redirectResponse)
 {
     QUrl url = newRequest.url();
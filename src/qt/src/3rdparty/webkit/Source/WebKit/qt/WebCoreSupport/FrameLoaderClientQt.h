@@ -93,6 +93,7 @@ public:
     virtual void detachedFromParent3();
 
     virtual void assignIdentifierToInitialRequest(unsigned long identifier, WebCore::DocumentLoader*, const WebCore::ResourceRequest&);
+    virtual WebCore::ResourceLoadPriority resourceLoadPriority(const WebCore::ResourceRequest&, WebCore::ResourceLoadPriority defaultPriority);
 
     virtual void dispatchWillSendRequest(WebCore::DocumentLoader*, unsigned long, WebCore::ResourceRequest&, const WebCore::ResourceResponse&);
     virtual bool shouldUseCredentialStorage(DocumentLoader*, unsigned long identifier);
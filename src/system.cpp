@@ -31,12 +31,14 @@
 #include "system.h"
 
 #include <QApplication>
+#include <QDebug>
 #include <QSslSocket>
 #include <QSysInfo>
 #include <QVariantMap>
 #include <QTextCodec>
 
 #include "../env.h"
+#include "childprocess.h"
 #include "terminal.h"
 
 System::System(QObject *parent) :
@@ -199,7 +201,14 @@ QObject *System::_stderr() {
 QObject *System::_stdin() {
     if ((File *)NULL == m_stdin) {
         QFile *f = new QFile();
-        f->open(stdin, QIODevice::ReadOnly | QIODevice::Unbuffered);
+        if (ChildProcess::isForkedProcess()) {
+            // Stdin carries the parent's messages: reading it here would steal them
+            qDebug() << "System - stdin: Not available in a forked process, use child_process.parent";
+            f->setFileName("/dev/null");
+            f->open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+        } else {
+            f->open(stdin, QIODevice::ReadOnly | QIODevice::Unbuffered);
+        }
         m_stdin = createFileInstance(f);
     }
 
@@ -30,10 +30,17 @@
 
 #include <QFile>
 #include <QDebug>
+#include <QCryptographicHash>
 #include <QDateTime>
+#include <QDesktopServices>
 #include <QDir>
+#include <QFileInfo>
 #include <QTemporaryFile>
 
+#ifdef Q_OS_UNIX
+#include <utime.h>
+#endif
+
 #include "consts.h"
 #include "terminal.h"
 #include "utils.h"
@@ -96,7 +103,56 @@ bool Utils::exceptionHandler(const char* dump_path, const char* minidump_id, voi
 
 QVariant Utils::coffee2js(const QString &script)
 {
-    return CSConverter::instance()->convert(script);
+    // Compiling needs the CoffeeScript compiler loaded first: reuse the output of previous runs
+    QFile cachedFile(coffeeCacheFilePath(script));
+    if (cachedFile.open(QFile::ReadOnly)) {
+#ifdef Q_OS_UNIX
+        // Entries are evicted least recently used first
+        ::utime(QFile::encodeName(cachedFile.fileName()).constData(), NULL);
+#endif
+        return QStringList() << "true" << QString::fromUtf8(cachedFile.readAll());
+    }
+
+    QVariant result = CSConverter::instance()->convert(script);
+    QStringList compiled = result.toStringList();
+    if (compiled.size() == 2 && compiled.at(0) == "true") {
+        // Written aside, then renamed: concurrent runs never read a partial file
+        QDir().mkpath(QFileInfo(cachedFile).absolutePath());
+        QTemporaryFile tempFile(cachedFile.fileName());
+        if (tempFile.open() && tempFile.write(compiled.at(1).toUtf8()) != -1 && tempFile.flush()) {
+            if (tempFile.rename(cachedFile.fileName())) {
+                tempFile.setAutoRemove(false);
+            }
+        }
+        pruneCacheDirectory(QFileInfo(cachedFile).absolutePath(), COFFEE_SCRIPT_CACHE_MAX_SIZE);
+    }
+    return result;
+}
+
+void Utils::pruneCacheDirectory(const QString &path, const qint64 maxSize)
+{
+    // Keep the most recently used files that fit, the others go
+    QFileInfoList entries = QDir(path).entryInfoList(QDir::Files, QDir::Time);
+    qint64 size = 0;
+    foreach (const QFileInfo &entry, entries) {
+        size += entry.size();
+        if (size > maxSize) {
+            QFile::remove(entry.absoluteFilePath());
+        }
+    }
+}
+
+QString Utils::coffeeCacheFilePath(const QString &script)
+{
+    // The output only depends on the source and on the compiler, which ships with PhantomJS
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(PHANTOMJS_VERSION_STRING);
+    hash.addData(script.toUtf8());
+
+    return QString("%1/%2/%3.js")
+            .arg(QDesktopServices::storageLocation(QDesktopServices::CacheLocation))
+            .arg(COFFEE_SCRIPT_CACHE_DIR)
+            .arg(QString::fromLatin1(hash.result().toHex()));
 }
 
 bool Utils::injectJsInFrame(const QString &jsFilePath, const QString &libraryPath, QWebFrame *targetFrame, const bool startingScript)
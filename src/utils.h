@@ -71,6 +71,12 @@ public:
 private:
     static QString findScript(const QString &jsFilePath, const QString& libraryPath);
     static QString jsFromScriptFile(const QString& scriptPath, const Encoding& enc);
+    static QString coffeeCacheFilePath(const QString &script);
+    /**
+     * Removes the least recently modified files of a directory until the
+     * others fit in the given size (bytes).
+     */
+    static void pruneCacheDirectory(const QString &path, const qint64 maxSize);
     Utils(); //< This class shouldn't be instantiated
 
     static QTemporaryFile* m_tempHarness; //< We want to make sure to clean up after ourselves
@@ -66,6 +66,8 @@
 #include "callback.h"
 #include "cookiejar.h"
 #include "system.h"
+#include "metrics.h"
+#include "DumpRenderTreeSupportQt.h"
 
 #ifdef Q_OS_WIN32
 #include <io.h>
@@ -78,6 +80,26 @@
 #define INPAGE_CALL_NAME                "window.callPhantom"
 #define CALLBACKS_OBJECT_INJECTION      INPAGE_CALL_NAME" = function() { return window."CALLBACKS_OBJECT_NAME".call.call(_phantom, Array.prototype.splice.call(arguments, 0)); };"
 #define CALLBACKS_OBJECT_PRESENT        "typeof(window."CALLBACKS_OBJECT_NAME") !== \"undefined\";"
+// Compiled functions are held by a closure behind a non-enumerable, read-only property.
+// This only keeps them out of the way: page scripts share the frame's global object,
+// so they can still call or redefine them, and see their arguments.
+#define COMPILED_FUNCTIONS_NAME         "window._phantomCompiled"
+#define COMPILED_FUNCTIONS_STORE        "if (!window.hasOwnProperty(\"_phantomCompiled\")) {" \
+    "Object.defineProperty(window, \"_phantomCompiled\", { value: (function () {" \
+        "var functions = {};" \
+        "return Object.freeze({" \
+            "define: function (id, f) { functions[id] = f; }," \
+            "release: function (id) { delete functions[id]; }," \
+            "invoke: function (id, args) { return functions.hasOwnProperty(id) ? [functions[id].apply(window, args)] : { missing: true }; }" \
+        "});" \
+    "})() });" \
+"}"
+#define COMPILED_FUNCTION_DEFINE        COMPILED_FUNCTIONS_STORE COMPILED_FUNCTIONS_NAME ".define(%1, (%2)); true;"
+// Wraps the result in an array, or returns { missing: true } if the frame doesn't have the
+// function (yet). A function that throws makes the whole evaluation null.
+#define COMPILED_FUNCTION_INVOKE        "typeof(" COMPILED_FUNCTIONS_NAME ") === \"object\" ? " \
+    COMPILED_FUNCTIONS_NAME ".invoke(%1, window." CALLBACKS_OBJECT_NAME ".evaluateArguments) : { missing: true };"
+#define COMPILED_FUNCTION_RELEASE       "if (typeof(" COMPILED_FUNCTIONS_NAME ") === \"object\") " COMPILED_FUNCTIONS_NAME ".release(%1);"
 
 #define STDOUT_FILENAME "/dev/stdout"
 #define STDERR_FILENAME "/dev/stderr"
@@ -243,6 +265,7 @@ private:
 class WebpageCallbacks : public QObject
 {
     Q_OBJECT
+    Q_PROPERTY(QVariantList evaluateArguments READ evaluateArguments)
 
 public:
     WebpageCallbacks(QObject *parent = 0)
@@ -290,6 +313,10 @@ public:
         return m_jsPromptCallback;
     }
 
+    QVariantList evaluateArguments() const {
+        return m_evaluateArguments;
+    }
+
 public slots:
     QVariant call(const QVariantList &arguments) {
         if (m_genericCallback) {
@@ -303,10 +330,13 @@ private:
     Callback *m_filePickerCallback;
     Callback *m_jsConfirmCallback;
     Callback *m_jsPromptCallback;
+    QVariantList m_evaluateArguments;
 
     friend class WebPage;
 };
 
+static void injectCallbacksObjIntoFrame(QWebFrame *frame, WebpageCallbacks *callbacksObject);
+
 
 WebPage::WebPage(QObject *parent, const QUrl &baseUrl)
     : QObject(parent)
@@ -314,6 +344,10 @@ WebPage::WebPage(QObject *parent, const QUrl &baseUrl)
     , m_mousePos(QPoint(0, 0))
     , m_ownsPages(true)
     , m_loadingProgress(0)
+    , m_nextCompiledFunctionId(0)
+    , m_baseUrl(baseUrl)
+    , m_visuallyCompleteTime(500)
+    , m_watchingRepaints(false)
 {
     setObjectName("WebPage");
     m_callbacks = new WebpageCallbacks(this);
@@ -343,9 +377,16 @@ WebPage::WebPage(QObject *parent, const QUrl &baseUrl)
     connect(m_mainFrame, SIGNAL(javaScriptWindowObjectCleared()), SIGNAL(initialized()));
     connect(m_mainFrame, SIGNAL(urlChanged(QUrl)), SIGNAL(urlChanged(QUrl)));
     connect(m_customWebPage, SIGNAL(loadStarted()), SIGNAL(loadStarted()), Qt::QueuedConnection);
+    connect(m_customWebPage, SIGNAL(loadStarted()), SLOT(startLoadTimer()));
+    connect(m_customWebPage, SIGNAL(loadStarted()), SLOT(stopVisuallyCompleteTimer()));
     connect(m_customWebPage, SIGNAL(loadFinished(bool)), SLOT(finish(bool)), Qt::QueuedConnection);
     connect(m_customWebPage, SIGNAL(windowCloseRequested()), this, SLOT(close()), Qt::QueuedConnection);
     connect(m_customWebPage, SIGNAL(loadProgress(int)), this, SLOT(updateLoadingProgress(int)));
+    connect(m_customWebPage, SIGNAL(repaintRequested(QRect)), SLOT(handleRepaintRequested(QRect)));
+    connect(m_customWebPage, SIGNAL(scrollRequested(int, int, QRect)), SLOT(handleScrollRequested(int, int, QRect)));
+
+    m_visuallyCompleteTimer.setSingleShot(true);
+    connect(&m_visuallyCompleteTimer, SIGNAL(timeout()), SLOT(handleVisuallyComplete()));
 
     // Start with transparent background.
     QPalette palette = m_customWebPage->palette();
@@ -388,6 +429,7 @@ WebPage::WebPage(QObject *parent, const QUrl &baseUrl)
             SIGNAL(resourceError(QVariant)));
     connect(m_networkAccessManager, SIGNAL(resourceTimeout(QVariant)),
             SIGNAL(resourceTimeout(QVariant)));
+    connect(m_networkAccessManager, SIGNAL(networkIdle()), SIGNAL(networkIdle()));
 
     m_customWebPage->setViewportSize(QSize(400, 300));
 }
@@ -589,6 +631,17 @@ void WebPage::applySettings(const QVariantMap &def)
     if (def.contains(PAGE_SETTINGS_RESOURCE_TIMEOUT))
         m_networkAccessManager->setResourceTimeout(def[PAGE_SETTINGS_RESOURCE_TIMEOUT].toInt());
 
+    if (def.contains(PAGE_SETTINGS_MAX_REQUESTS_PER_HOST))
+        DumpRenderTreeSupportQt::setMaximumRequestsInFlightPerHost(m_customWebPage, def[PAGE_SETTINGS_MAX_REQUESTS_PER_HOST].toInt());
+
+    if (def.contains(PAGE_SETTINGS_RESOURCE_PRIORITIES))
+        DumpRenderTreeSupportQt::setResourceLoadPriorityRules(m_customWebPage, def[PAGE_SETTINGS_RESOURCE_PRIORITIES].toList());
+
+    if (def.contains(PAGE_SETTINGS_NETWORK_IDLE_TIME))
+        m_networkAccessManager->setNetworkIdleTime(def[PAGE_SETTINGS_NETWORK_IDLE_TIME].toInt());
+
+    if (def.contains(PAGE_SETTINGS_VISUALLY_COMPLETE_TIME))
+        m_visuallyCompleteTime = def[PAGE_SETTINGS_VISUALLY_COMPLETE_TIME].toInt();
 }
 
 QString WebPage::userAgent() const
@@ -687,6 +740,64 @@ QVariant WebPage::evaluateJavaScript(const QString &code)
     return evalResult;
 }
 
+int WebPage::_compileFunction(const QString &source)
+{
+    const int id = m_nextCompiledFunctionId++;
+    m_compiledFunctions.insert(id, source);
+
+    qDebug() << "WebPage - _compileFunction" << id;
+
+    return id;
+}
+
+QVariant WebPage::_callCompiledFunction(const int id, const QVariantList &args)
+{
+    if (!m_compiledFunctions.contains(id)) {
+        qDebug() << "WebPage - _callCompiledFunction" << "unknown function:" << id;
+        return QVariant();
+    }
+
+    // Arguments travel through the bridge as variants, no need to serialize them in the source
+    m_callbacks->m_evaluateArguments = args;
+    QVariant evalResult = m_currentFrame->evaluateJavaScript(
+                QString(COMPILED_FUNCTION_INVOKE).arg(id),
+                QString("phantomjs://webpage.compile()"));
+
+    // The store lives in the frame's global object: compile the function
+    // only the first time it's invoked after a (re)load of the Current Frame.
+    // A function that threw is not run again.
+    if (evalResult.toMap().value("missing").toBool()) {
+        qDebug() << "WebPage - _callCompiledFunction" << "compiling:" << id;
+
+        injectCallbacksObjIntoFrame(m_currentFrame, m_callbacks);
+        m_currentFrame->evaluateJavaScript(
+                    QString(COMPILED_FUNCTION_DEFINE).arg(id).arg(m_compiledFunctions.value(id)),
+                    QString("phantomjs://webpage.compile()"));
+        evalResult = m_currentFrame->evaluateJavaScript(
+                    QString(COMPILED_FUNCTION_INVOKE).arg(id),
+                    QString("phantomjs://webpage.compile()"));
+    }
+    m_callbacks->m_evaluateArguments.clear();
+
+    QVariantList wrappedResult = evalResult.toList();
+    return wrappedResult.isEmpty() ? QVariant() : wrappedResult.first();
+}
+
+static void releaseCompiledFunctionInFrame(QWebFrame *frame, const int id)
+{
+    frame->evaluateJavaScript(QString(COMPILED_FUNCTION_RELEASE).arg(id));
+    foreach (QWebFrame *childFrame, frame->childFrames()) {
+        releaseCompiledFunctionInFrame(childFrame, id);
+    }
+}
+
+void WebPage::_releaseCompiledFunction(const int id)
+{
+    if (m_compiledFunctions.remove(id)) {
+        releaseCompiledFunctionInFrame(m_mainFrame, id);
+    }
+}
+
 QString WebPage::filePicker(const QString &oldFile)
 {
     qDebug() << "WebPage - filePicker" << "- old file:" << oldFile;
@@ -731,6 +842,19 @@ bool WebPage::javaScriptPrompt(const QString &msg, const QString &defaultValue,
 
 void WebPage::finish(bool ok)
 {
+    if (m_loadTimer.isValid()) {
+        Metrics::instance()->recordPageLoad(m_loadTimer.elapsed(), ok);
+        m_loadTimer.invalidate();
+    }
+
+    // Before "loadFinished": its handler may well start another load
+    if (m_visuallyCompleteTime > 0) {
+        m_watchingRepaints = true;
+        m_visuallyCompleteTimer.start(m_visuallyCompleteTime);
+    }
+    // A load served without requests (e.g. from the cache) never finishes one
+    m_networkAccessManager->startNetworkIdleTimer();
+
     QString status = ok ? "success" : "fail";
     emit loadFinished(status);
 }
@@ -851,6 +975,39 @@ void WebPage::close() {
     deleteLater();
 }
 
+void WebPage::_reset()
+{
+    m_customWebPage->triggerAction(QWebPage::Stop);
+
+    // Pages opened by this one go away with its content
+    foreach (WebPage *childPage, findChildren<WebPage *>()) {
+        if (childPage->parent() == this) {
+            childPage->close();
+        }
+    }
+
+    m_networkAccessManager->reset();
+    applySettings(Phantom::instance()->defaultPageSettings());
+    stopVisuallyCompleteTimer();
+
+    m_navigationLocked = false;
+    m_mousePos = QPoint(0, 0);
+    m_ownsPages = true;
+    m_loadingProgress = 0;
+    m_compiledFunctions.clear();
+    m_clipRect = QRect();
+    m_scrollPosition = QPoint();
+    m_paperSize.clear();
+    m_mainFrame->setScrollPosition(QPoint());
+    m_mainFrame->setZoomFactor(1.0);
+    m_customWebPage->setViewportSize(QSize(400, 300));
+
+    // A new document comes with new JS globals
+    m_currentFrame = m_mainFrame;
+    m_mainFrame->setHtml(BLANK_HTML, m_baseUrl);
+    m_customWebPage->history()->clear();
+}
+
 bool WebPage::render(const QString &fileName, const QVariantMap &option)
 {
     if (m_mainFrame->contentsSize().isEmpty())
@@ -974,6 +1131,9 @@ QString WebPage::renderBase64(const QByteArray &format)
 
 QImage WebPage::renderImage()
 {
+    QElapsedTimer renderTimer;
+    renderTimer.start();
+
     QSize contentsSize = m_mainFrame->contentsSize();
     contentsSize -= QSize(m_scrollPosition.x(), m_scrollPosition.y());
     QRect frameRect = QRect(QPoint(0, 0), contentsSize);
@@ -1025,6 +1185,8 @@ QImage WebPage::renderImage()
     }
 
     m_customWebPage->setViewportSize(viewportSize);
+
+    Metrics::instance()->recordRender(renderTimer.elapsed(), (qint64) buffer.width() * buffer.height());
     return buffer;
 }
 
@@ -1250,6 +1412,30 @@ void WebPage::_uploadFile(const QString &selector, const QStringList &fileNames)
     el.evaluateJavaScript(JS_ELEMENT_CLICK);
 }
 
+bool WebPage::_startProfiling(int intervalInMicroseconds)
+{
+    bool started = DumpRenderTreeSupportQt::startJavaScriptSampling(m_mainFrame, intervalInMicroseconds);
+    if (!started) {
+        qDebug() << "WebPage - Could not start the JavaScript profiler (is it already running?)";
+    }
+    return started;
+}
+
+QVariantMap WebPage::_stopProfiling()
+{
+    return DumpRenderTreeSupportQt::stopJavaScriptSampling(m_mainFrame);
+}
+
+QVariantMap WebPage::memoryStats(const bool objectCounts)
+{
+    QVariantMap stats = DumpRenderTreeSupportQt::memoryStatistics();
+    if (objectCounts) {
+        stats["jsObjectCounts"] = DumpRenderTreeSupportQt::javaScriptObjectTypeCounts();
+    }
+    stats["page"] = DumpRenderTreeSupportQt::frameMemoryStatistics(m_mainFrame);
+    return stats;
+}
+
 bool WebPage::injectJs(const QString &jsFilePath) {
     return Utils::injectJsInFrame(jsFilePath, m_libraryPath, m_currentFrame);
 }
@@ -1580,4 +1766,39 @@ void WebPage::updateLoadingProgress(int progress)
     m_loadingProgress = progress;
 }
 
+void WebPage::startLoadTimer()
+{
+    m_loadTimer.start();
+}
+
+void WebPage::stopVisuallyCompleteTimer()
+{
+    // Until the load finishes, or for good after "visuallyComplete"
+    m_watchingRepaints = false;
+    m_visuallyCompleteTimer.stop();
+}
+
+void WebPage::handleRepaintRequested(const QRect &dirtyRect)
+{
+    if (!m_watchingRepaints)
+        return;
+
+    // Repaints below the fold do not change what a screenshot shows
+    if (dirtyRect.intersects(QRect(QPoint(0, 0), m_customWebPage->viewportSize())))
+        m_visuallyCompleteTimer.start(m_visuallyCompleteTime);
+}
+
+void WebPage::handleScrollRequested(int dx, int dy, const QRect &scrollViewRect)
+{
+    Q_UNUSED(dx);
+    Q_UNUSED(dy);
+    handleRepaintRequested(scrollViewRect);
+}
+
+void WebPage::handleVisuallyComplete()
+{
+    stopVisuallyCompleteTimer();
+    emit visuallyComplete();
+}
+
 #include "webpage.moc"
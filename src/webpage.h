@@ -31,7 +31,10 @@
 #ifndef WEBPAGE_H
 #define WEBPAGE_H
 
+#include <QElapsedTimer>
+#include <QHash>
 #include <QMap>
+#include <QTimer>
 #include <QVariantMap>
 #include <QWebPage>
 #include <QWebFrame>
@@ -236,8 +239,42 @@ public slots:
     void openUrl(const QString &address, const QVariant &op, const QVariantMap &settings);
     void release();
     void close();
+    /**
+     * Brings the page back to the state of a newly created one (content, history,
+     * JS globals, settings, per-page network state, child pages), while keeping
+     * the underlying QWebPage and NetworkAccessManager alive for reuse.
+     *
+     * @brief _reset
+     */
+    void _reset();
 
     QVariant evaluateJavaScript(const QString &code);
+    /**
+     * Registers the source of a function to be evaluated repeatedly in the page.
+     * The source is compiled lazily, once per frame, by {@link _callCompiledFunction()}.
+     *
+     * @brief _compileFunction
+     * @param source Source of the function
+     * @return Handle of the registered function
+     */
+    int _compileFunction(const QString &source);
+    /**
+     * Invokes a function registered with {@link _compileFunction()} in the Current Frame.
+     * Arguments are passed to the page as they are, without being serialized into source.
+     *
+     * @brief _callCompiledFunction
+     * @param id Handle of the registered function
+     * @param args Arguments of the function call
+     * @return The function call result
+     */
+    QVariant _callCompiledFunction(const int id, const QVariantList &args);
+    /**
+     * Forgets a function registered with {@link _compileFunction()}, dropping it from every frame.
+     *
+     * @brief _releaseCompiledFunction
+     * @param id Handle of the registered function
+     */
+    void _releaseCompiledFunction(const int id);
     bool render(const QString &fileName, const QVariantMap &map = QVariantMap());
     /**
      * Render the page as base-64 encoded string.
@@ -259,6 +296,18 @@ public slots:
     QObject *_getJsConfirmCallback();
     QObject *_getJsPromptCallback();
     void _uploadFile(const QString &selector, const QStringList &fileNames);
+    bool _startProfiling(int intervalInMicroseconds);
+    QVariantMap _stopProfiling();
+    /**
+     * The process-wide memory breakdown of <code>phantom.memoryStats()</code>,
+     * with what the page holds on to under <code>"page"</code>: its frames,
+     * DOM nodes, and the images and other resources its documents use.
+     *
+     * @brief memoryStats
+     * @param objectCounts Whether to add the number of live JavaScript objects by class
+     * @return The memory breakdown
+     */
+    QVariantMap memoryStats(const bool objectCounts = false);
     void sendEvent(const QString &type, const QVariant &arg1 = QVariant(), const QVariant &arg2 = QVariant(), const QString &mouseButton = QString(), const QVariant &modifierArg = QVariant());
 
     void setContent(const QString &content, const QString &baseUrl);
@@ -474,11 +523,27 @@ signals:
     void navigationRequested(const QUrl &url, const QString &navigationType, bool navigationLocked, bool isMainFrame);
     void rawPageCreated(QObject *page);
     void closing(QObject *page);
+    /**
+     * No request of the page has been in flight for the "networkIdleTime"
+     * page setting (ms). Emitted again after each new burst of requests.
+     */
+    void networkIdle();
+    /**
+     * The page has finished loading and nothing in the viewport has been
+     * repainted for the "visuallyCompleteTime" page setting (ms).
+     * Emitted once per load.
+     */
+    void visuallyComplete();
 
 private slots:
     void finish(bool ok);
     void setupFrame(QWebFrame *frame = NULL);
     void updateLoadingProgress(int progress);
+    void startLoadTimer();
+    void stopVisuallyCompleteTimer();
+    void handleRepaintRequested(const QRect &dirtyRect);
+    void handleScrollRequested(int dx, int dy, const QRect &scrollViewRect);
+    void handleVisuallyComplete();
 
 private:
     QImage renderImage();
@@ -513,6 +578,13 @@ private:
     QPoint m_mousePos;
     bool m_ownsPages;
     int m_loadingProgress;
+    QHash<int, QString> m_compiledFunctions;
+    int m_nextCompiledFunctionId;
+    QUrl m_baseUrl; // Of the blank document a new or reset page starts with
+    QElapsedTimer m_loadTimer;
+    int m_visuallyCompleteTime;
+    QTimer m_visuallyCompleteTimer;
+    bool m_watchingRepaints;
 
     friend class Phantom;
     friend class CustomPage;
@@ -0,0 +1,190 @@
+describe("child_process.fork()", function() {
+    var fs = require('fs'),
+        childProcess = require('child_process'),
+        childScript = fs.absolute("fork-spec-child.js");
+
+    afterEach(function() {
+        if (fs.exists(childScript)) {
+            fs.remove(childScript);
+        }
+    });
+
+    it("should have no parent channel when not forked", function() {
+        expect(childProcess.parent).toBeNull();
+    });
+
+    it("should exchange messages with the child", function() {
+        var child, reply = null, exitCode = null;
+
+        fs.write(childScript, [
+            "var parent = require('child_process').parent;",
+            "parent.on('message', function (message) {",
+            "    parent.send({ doubled: message.value * 2 });",
+            "    phantom.exit(0);",
+            "});"
+        ].join("\n"), "w");
+
+        child = childProcess.fork(childScript);
+        child.on("message", function (message) {
+            reply = message;
+        });
+        child.on("exit", function (code) {
+            exitCode = code;
+        });
+        child.send({ value: 21 });
+
+        waitsFor(function() {
+            return exitCode !== null;
+        }, "the child to exit", 10000);
+
+        runs(function() {
+            expect(reply).toEqual({ doubled: 42 });
+            expect(exitCode).toEqual(0);
+        });
+    });
+
+    it("should deliver a last line without line break before 'exit'", function() {
+        var child, output = "", outputAtExit = null;
+
+        fs.write(childScript, "require('system').stdout.write('no line break'); phantom.exit(0);", "w");
+
+        child = childProcess.fork(childScript);
+        child.stdout.on("data", function (data) {
+            output += data;
+        });
+        child.on("exit", function () {
+            outputAtExit = output;
+        });
+
+        waitsFor(function() {
+            return outputAtExit !== null;
+        }, "the child to exit", 10000);
+
+        runs(function() {
+            expect(outputAtExit).toEqual("no line break");
+        });
+    });
+
+    it("should not pass the forked state on to the processes the child starts", function() {
+        var child, reply = null, exitCode = null;
+
+        fs.write(childScript, [
+            "var childProcess = require('child_process');",
+            "childProcess.execFile('env', [], null, function (err, stdout) {",
+            "    childProcess.parent.send({ forked: childProcess.parent !== null,",
+            "        inherited: stdout.indexOf('PHANTOMJS_FORKED=') !== -1 });",
+            "    phantom.exit(0);",
+            "});"
+        ].join("\n"), "w");
+
+        child = childProcess.fork(childScript);
+        child.on("message", function (message) {
+            reply = message;
+        });
+        child.on("exit", function (code) {
+            exitCode = code;
+        });
+
+        waitsFor(function() {
+            return exitCode !== null;
+        }, "the child to exit", 10000);
+
+        runs(function() {
+            expect(reply).toEqual({ forked: true, inherited: false });
+            expect(exitCode).toEqual(0);
+        });
+    });
+});
+
+describe("child_process stdin and flow control", function() {
+    var childProcess = require('child_process');
+
+    it("should write to the child's stdin", function() {
+        var child = childProcess.spawn("cat"), output = "", exited = false;
+
+        child.stdout.on("data", function (data) {
+            output += data;
+        });
+        child.on("exit", function () {
+            exited = true;
+        });
+        child.stdin.write("hello ");
+        child.stdin.end("world");
+
+        waitsFor(function() {
+            return exited;
+        }, "cat to exit", 5000);
+
+        runs(function() {
+            expect(output).toEqual("hello world");
+        });
+    });
+
+    it("should deliver binary output as byte arrays", function() {
+        var child = childProcess.spawn("cat", [], { encoding: "binary" }), bytes = [], exited = false;
+
+        child.stdout.on("data", function (data) {
+            for (var i = 0; i < data.length; ++i) {
+                bytes.push(data[i]);
+            }
+        });
+        child.on("exit", function () {
+            exited = true;
+        });
+        child.stdin.end("\u0000ÿ\u0001", "binary");
+
+        waitsFor(function() {
+            return exited;
+        }, "cat to exit", 5000);
+
+        runs(function() {
+            expect(bytes).toEqual([0, 255, 1]);
+        });
+    });
+
+    it("should hold 'exit' until the output kept while paused is delivered", function() {
+        var child = childProcess.spawn("sh", ["-c", "echo paused output"]), events = [];
+
+        child.stdout.pause();
+        child.stdout.on("data", function (data) {
+            events.push("data:" + data);
+        });
+        child.on("exit", function () {
+            events.push("exit");
+        });
+
+        waits(1000);
+
+        runs(function() {
+            // The child is long gone, but its output is still held
+            expect(events).toEqual([]);
+            child.stdout.resume();
+            expect(events).toEqual(["data:paused output\n", "exit"]);
+        });
+    });
+
+    it("should emit 'exit' once, after the output kept while paused, when the child crashes", function() {
+        var child = childProcess.spawn("sh", ["-c", "echo crashing; kill -SEGV $$"]), events = [];
+
+        child.stdout.pause();
+        child.stdout.on("data", function (data) {
+            events.push("data:" + data);
+        });
+        child.on("exit", function () {
+            events.push("exit");
+        });
+
+        waits(1000);
+
+        runs(function() {
+            expect(events).toEqual([]);
+            child.stdout.resume();
+        });
+
+        waits(100);
+
+        runs(function() {
+            expect(events).toEqual(["data:crashing\n", "exit"]);
+        });
+    });
+});
@@ -0,0 +1,67 @@
+describe("Fork server", function() {
+    var fs = require('fs'),
+        socketPath = fs.absolute("fork-server-spec.sock"),
+        slowScript = fs.absolute("fork-server-slow.js"),
+        quickScript = fs.absolute("fork-server-quick.js");
+
+    // A PhantomJS started with "--fork-client" sends its script to the server
+    function request(script) {
+        return runPhantom(["--fork-client=" + socketPath], script);
+    }
+
+    it("should keep serving after a worker exits, even if its client went away", function() {
+        var server, listing = null, dropped, first, second;
+
+        fs.write(slowScript, "setTimeout(function () { console.log('slow'); phantom.exit(3); }, 1000);", "w");
+        fs.write(quickScript, "console.log('quick'); phantom.exit(5);", "w");
+
+        server = runPhantom(["--fork-server=" + socketPath]);
+
+        waits(2000);
+
+        runs(function() {
+            // Only the owner may connect
+            require('child_process').execFile("ls", ["-l", socketPath], null, function (err, stdout) {
+                listing = stdout;
+            });
+            dropped = request(slowScript);
+        });
+
+        waits(300);
+
+        runs(function() {
+            dropped.child.kill();
+        });
+
+        // Let the slow worker exit with its client gone
+        waits(1500);
+
+        runs(function() {
+            first = request(quickScript);
+        });
+
+        waitsFor(function() {
+            return first.exitCode !== null;
+        }, "the server to answer another request", 5000);
+
+        // A worker that exited normally must leave the server's socket in place
+        runs(function() {
+            second = request(quickScript);
+        });
+
+        waitsFor(function() {
+            return second.exitCode !== null;
+        }, "the server to answer after a normal exit", 5000);
+
+        runs(function() {
+            expect(listing).toMatch(/^srwx------/);
+            [first, second].forEach(function (reply) {
+                expect(reply.output).toEqual("quick\n");
+                expect(reply.exitCode).toEqual(5);
+            });
+            server.child.kill();
+            fs.remove(slowScript);
+            fs.remove(quickScript);
+        });
+    });
+});
@@ -216,4 +216,35 @@ describe("Basic Files API (read, write, remove, ...)", function() {
         } catch (e) { }
         expect(content).toEqual(output);
     });
+
+    it("should read/write byte arrays", function() {
+        var content, output = new Uint8Array([0, 1, 2, 128, 255]);
+        try {
+            fs.writeBytes(FILENAME_BIN, output);
+
+            content = fs.readBytes(FILENAME_BIN);
+
+            fs.remove(FILENAME_BIN);
+        } catch (e) { }
+        expect(content.length).toEqual(5);
+        expect(content[0]).toEqual(0);
+        expect(content[3]).toEqual(128);
+        expect(content[4]).toEqual(255);
+    });
+
+    it("should be able to stream binary data in chunks", function() {
+        var chunks = [];
+        try {
+            fs.write(FILENAME_BIN, String.fromCharCode(0, 1, 2, 3, 4), "b");
+
+            var f = fs.open(FILENAME_BIN, "rb");
+            while (!f.atEnd()) {
+                chunks.push(f.readBytes(2).length);
+            }
+            f.close();
+
+            fs.remove(FILENAME_BIN);
+        } catch (e) { }
+        expect(chunks).toEqual([2, 2, 1]);
+    });
 });
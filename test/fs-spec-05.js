@@ -0,0 +1,98 @@
+describe("Asynchronous Files API", function() {
+    var TEST_DIR = "testdir05",
+        TEST_DIR_COPY = TEST_DIR + "-copy",
+        TEST_FILE = "testfile05",
+        TEST_FILE_PATH = fs.join(TEST_DIR, "sub", TEST_FILE),
+        TEST_CONTENT = "test content",
+        ABSENT_FILE = "absentfile05";
+
+    it("should write and read back a file", function() {
+        var done = false, error, content;
+
+        runs(function() {
+            fs.writeAsync(TEST_FILE_PATH, TEST_CONTENT, function(err) {
+                expect(err).toBeNull();
+                fs.readAsync(TEST_FILE_PATH, function(err, result) {
+                    error = err;
+                    content = result;
+                    done = true;
+                });
+            });
+        });
+
+        waitsFor(function() { return done; }, "the file to be read", 3000);
+
+        runs(function() {
+            expect(error).toBeNull();
+            expect(content).toEqual(TEST_CONTENT);
+        });
+    });
+
+    it("should report an error when reading a file that doesn't exist", function() {
+        var done = false, error;
+
+        runs(function() {
+            fs.readAsync(ABSENT_FILE, function(err) {
+                error = err;
+                done = true;
+            });
+        });
+
+        waitsFor(function() { return done; }, "the read to fail", 3000);
+
+        runs(function() {
+            expect(error.message).toEqual("Unable to read file '" + ABSENT_FILE + "'");
+        });
+    });
+
+    it("should copy a directory tree", function() {
+        var done = false, error;
+
+        runs(function() {
+            fs.copyTreeAsync(TEST_DIR, TEST_DIR_COPY, function(err) {
+                error = err;
+                done = true;
+            });
+        });
+
+        waitsFor(function() { return done; }, "the tree to be copied", 3000);
+
+        runs(function() {
+            expect(error).toBeNull();
+            expect(fs.read(fs.join(TEST_DIR_COPY, "sub", TEST_FILE))).toEqual(TEST_CONTENT);
+        });
+    });
+
+    it("should list a directory", function() {
+        var done = false, entries;
+
+        runs(function() {
+            fs.listAsync(fs.join(TEST_DIR_COPY, "sub"), function(err, result) {
+                entries = result;
+                done = true;
+            });
+        });
+
+        waitsFor(function() { return done; }, "the directory to be listed", 3000);
+
+        runs(function() {
+            expect(entries).toContain(TEST_FILE);
+        });
+    });
+
+    it("should remove the directory trees", function() {
+        var removed = 0;
+
+        runs(function() {
+            fs.removeTreeAsync(TEST_DIR, function(err) { expect(err).toBeNull(); ++removed; });
+            fs.removeTreeAsync(TEST_DIR_COPY, function(err) { expect(err).toBeNull(); ++removed; });
+        });
+
+        waitsFor(function() { return removed === 2; }, "the trees to be removed", 3000);
+
+        runs(function() {
+            expect(fs.exists(TEST_DIR)).toBeFalsy();
+            expect(fs.exists(TEST_DIR_COPY)).toBeFalsy();
+        });
+    });
+});
@@ -88,4 +88,115 @@ describe("phantom global object", function() {
         phantom.onError = undefined;
         expect(phantom.onError).toBeUndefined();
     });
+
+    it("should have 'metrics' property with the process-wide counters", function() {
+        expect(phantom.hasOwnProperty('metrics')).toBeTruthy();
+        var metrics = phantom.metrics;
+        expect(typeof metrics.uptime).toEqual('number');
+        expect(typeof metrics.pages.loads).toEqual('number');
+        expect(typeof metrics.resources.bytes).toEqual('number');
+        expect(typeof metrics.rendering.renders).toEqual('number');
+        expect(metrics.jsHeap.size).toBeGreaterThan(0);
+        expect(typeof metrics.eventLoop.maxLag).toEqual('number');
+        expect(metrics.regExp.cacheCapacity).toBeGreaterThan(0);
+    });
+
+    it("should measure event loop lag once 'metrics' has been read", function() {
+        var before = phantom.metrics.eventLoop.maxLag;
+
+        waits(200);
+
+        runs(function() {
+            // Block the event loop for longer than a probe interval
+            var start = Date.now();
+            while (Date.now() - start < 300) {}
+        });
+
+        waits(200);
+
+        runs(function() {
+            expect(phantom.metrics.eventLoop.maxLag).toBeGreaterThan(before);
+        });
+    });
+
+    it("should count regular expression cache hits in 'metrics'", function() {
+        var hits = phantom.metrics.regExp.cacheHits;
+        for (var i = 0; i < 3; ++i) {
+            new RegExp('metrics-spec-[0-9]+', 'g');
+        }
+        expect(phantom.metrics.regExp.cacheHits).toBeGreaterThan(hits);
+    });
+
+    it("should collect garbage on demand with 'gc()'", function() {
+        expect(typeof phantom.gc).toEqual('function');
+        var collections = phantom.heapStatistics.collections;
+        var stats = phantom.gc();
+        expect(stats.size).toBeGreaterThan(0);
+        expect(stats.collections).toBeGreaterThan(collections);
+    });
+
+    it("should break down memory use with 'memoryStats()'", function() {
+        var stats = phantom.memoryStats();
+        expect(stats.jsHeap.size).toBeGreaterThan(0);
+        expect(stats.jsHeap.blocks).toBeGreaterThan(0);
+        expect(typeof stats.memoryCache.images.decodedSize).toEqual('number');
+        expect(typeof stats.fontCache.glyphPages).toEqual('number');
+        expect(stats.jsObjectCounts).toBeUndefined();
+
+        stats = phantom.memoryStats(true);
+        expect(stats.jsObjectCounts.Function).toBeGreaterThan(0);
+    });
+
+    it("should size and prune the memory cache", function() {
+        var cache = phantom.memoryStats().memoryCache;
+        phantom.setMemoryCacheCapacities(1024, 4 * 1024 * 1024, 16 * 1024 * 1024);
+        var resized = phantom.memoryStats().memoryCache;
+        expect(resized.capacity).toEqual(16 * 1024 * 1024);
+        expect(resized.maxDeadCapacity).toEqual(4 * 1024 * 1024);
+        expect(resized.minDeadCapacity).toEqual(1024);
+        expect(typeof resized.hitRate).toEqual('number');
+
+        phantom.pruneMemoryCache();
+        expect(phantom.memoryStats().memoryCache.deadSize).toEqual(0);
+
+        phantom.setMemoryCacheCapacities(cache.minDeadCapacity, cache.maxDeadCapacity, cache.capacity);
+    });
+});
+
+describe("CoffeeScript compile cache", function() {
+    var fs = require('fs'),
+        system = require('system'),
+        coffeeScript = fs.absolute("coffee-cache-spec.coffee"),
+        // Where Qt puts the cache location on Linux
+        cacheDir = (system.env.XDG_CACHE_HOME || system.env.HOME + "/.cache") + "/Ofi Labs/PhantomJS/coffee-script",
+        staleEntry = cacheDir + "/stale-spec-entry.js";
+
+    if (system.os.name !== "linux") {
+        return;
+    }
+
+    it("should evict old entries once over its size limit", function() {
+        var run;
+
+        // Older than anything compiled from now on, and over the 5 MB limit on its own
+        fs.makeTree(cacheDir);
+        fs.write(staleEntry, new Array(5 * 1024 * 1024 + 2).join("x"), "w");
+        fs.write(coffeeScript, "console.log 'compiled at ' + " + Date.now() + "\nphantom.exit 0\n", "w");
+
+        waits(1100);
+
+        runs(function() {
+            run = runPhantom([coffeeScript]);
+        });
+
+        waitsFor(function() {
+            return run.exitCode !== null;
+        }, "the CoffeeScript child to exit", 10000);
+
+        runs(function() {
+            expect(run.output).toContain("compiled at");
+            expect(fs.exists(staleEntry)).toBeFalsy();
+            fs.remove(coffeeScript);
+        });
+    });
 });
@@ -56,6 +56,25 @@ function expectHasPropertyString(o, name) {
     });
 }
 
+// Runs this PhantomJS again with the given command line options and script.
+// The returned object collects the output, and gets the exit code last.
+function runPhantom(options, script) {
+    var args = options.concat(script ? [script] : []),
+        result = { output: "", errors: "", exitCode: null };
+
+    result.child = require('child_process').fork(args[0], args.slice(1));
+    result.child.stdout.on("data", function (data) {
+        result.output += data;
+    });
+    result.child.stderr.on("data", function (data) {
+        result.errors += data;
+    });
+    result.child.on("exit", function (code) {
+        result.exitCode = code;
+    });
+    return result;
+}
+
 // Setting the "working directory" to the "/test" directory
 var fs = require('fs');
 fs.changeWorkingDirectory(phantom.libraryPath);
@@ -68,7 +87,10 @@ phantom.injectJs("./fs-spec-01.js"); //< Filesystem Specs 01 (Basic)
 phantom.injectJs("./fs-spec-02.js"); //< Filesystem Specs 02 (Attributes)
 phantom.injectJs("./fs-spec-03.js"); //< Filesystem Specs 03 (Paths)
 phantom.injectJs("./fs-spec-04.js"); //< Filesystem Specs 04 (Tests)
+phantom.injectJs("./fs-spec-05.js"); //< Filesystem Specs 05 (Asynchronous)
 phantom.injectJs("./system-spec.js");
+phantom.injectJs("./child_process-spec.js");
+phantom.injectJs("./fork-server-spec.js");
 phantom.injectJs("./webkit-spec.js");
 require("./module_spec.js");
 require("./require/require_spec.js");
@@ -9,9 +9,404 @@ describe("WebKit", function() {
         expect(date).toEqual(1325376000000);
     });
 
+    it("should escape and unescape strings in JSON", function() {
+        var decoded = JSON.parse('"q\\"b\\\\s\\/n\\nr\\rt\\tb\\bf\\fu\\u00e9z\\u0000"');
+        expect(decoded).toEqual('q"b\\s/n\nr\rt\tb\bf\fuéz\u0000');
+        expect(JSON.stringify('q"b\\n\nt\tc\u0001\u001fé')).toEqual('"q\\"b\\\\n\\nt\\tc\\u0001\\u001fé"');
+        expect(JSON.parse(JSON.stringify(decoded))).toEqual(decoded);
+    });
+
+    it("should find special characters anywhere around the 8 and 16 character marks in JSON strings", function() {
+        var specials = ['"', '\\', '\n', '\u0001', '\u007f', 'é', ' '];
+        function escape(c) {
+            switch (c) {
+            case '"': return '\\"';
+            case '\\': return '\\\\';
+            case '\n': return '\\n';
+            case '\u0001': return '\\u0001';
+            default: return c;
+            }
+        }
+        for (var length = 1; length <= 40; ++length) {
+            for (var position = 0; position < length; ++position) {
+                for (var i = 0; i < specials.length; ++i) {
+                    var before = new Array(position + 1).join('a'),
+                        after = new Array(length - position).join('b'),
+                        string = before + specials[i] + after,
+                        encoded = JSON.stringify(string);
+                    expect(encoded).toEqual('"' + before + escape(specials[i]) + after + '"');
+                    expect(JSON.parse(encoded)).toEqual(string);
+                    expect(JSON.parse('{"' + string.replace(/["\\\n\u0001]/, 'k') + '":' + encoded + '}')[string.replace(/["\\\n\u0001]/, 'k')]).toEqual(string);
+                }
+            }
+        }
+    });
+
+    it("should parse and stringify nested arrays in JSON", function() {
+        var deep = [], current = deep;
+        for (var i = 0; i < 200; ++i) {
+            current.push(i, []);
+            current = current[1];
+        }
+        expect(JSON.parse(JSON.stringify(deep))).toEqual(deep);
+
+        var parsed = JSON.parse('[[],[[]],[1,[2,[3,"x",[true,null]]]],{"a":[[4],[5,6]]},[-0,2147483647,-2147483648,1e21]]');
+        expect(parsed.length).toEqual(5);
+        expect(parsed[0]).toEqual([]);
+        expect(parsed[1]).toEqual([[]]);
+        expect(parsed[2][1][1][2][0]).toBe(true);
+        expect(parsed[3].a[1]).toEqual([5, 6]);
+        expect(JSON.stringify(parsed[4])).toEqual('[0,2147483647,-2147483648,1e+21]');
+
+        var sparse = [1, , 3];
+        sparse[5] = undefined;
+        expect(JSON.stringify(sparse)).toEqual('[1,null,3,null,null,null]');
+    });
+
+    it("should keep the objects of long mixed arrays alive while parsing JSON", function() {
+        // Eight objects fill the inline buffer, then a number makes the elements spill
+        // out of it; the thousands of objects after that allocate enough to collect.
+        var parts = [];
+        for (var i = 0; i < 8; ++i) {
+            parts.push('{"n":' + i + '}');
+        }
+        parts.push('0');
+        for (i = 9; i < 20000; ++i) {
+            parts.push(i % 3 ? '{"n":' + i + ',"s":"item ' + i + '"}' : String(i));
+        }
+        var parsed = JSON.parse('[' + parts.join(',') + ']');
+        expect(parsed.length).toEqual(20000);
+        for (i = 0; i < 8; ++i) {
+            expect(parsed[i].n).toEqual(i);
+        }
+        expect(parsed[8]).toEqual(0);
+        var wrong = 0;
+        for (i = 9; i < 20000; ++i) {
+            if (i % 3 ? parsed[i].n !== i || parsed[i].s !== 'item ' + i : parsed[i] !== i) {
+                ++wrong;
+            }
+        }
+        expect(wrong).toEqual(0);
+    });
+
+    it("should stringify objects that share a shape in JSON", function() {
+        function Point(x, y) {
+            this.x = x;
+            this.y = y;
+        }
+        var points = [];
+        for (var i = 0; i < 50; ++i) {
+            points.push(new Point(i, -i));
+        }
+        expect(JSON.stringify(points.slice(0, 2))).toEqual('[{"x":0,"y":0},{"x":1,"y":-1}]');
+        expect(JSON.parse(JSON.stringify(points))).toEqual(points.map(function (p) { return { x: p.x, y: p.y }; }));
+
+        // Changes to the shape or the prototype chain after a first serialization
+        Point.prototype.toJSON = function () { return [this.x, this.y]; };
+        expect(JSON.stringify(points.slice(1, 3))).toEqual('[[1,-1],[2,-2]]');
+        delete Point.prototype.toJSON;
+        points[1].z = 'z';
+        delete points[2].x;
+        expect(JSON.stringify(points.slice(1, 3))).toEqual('[{"x":1,"y":-1,"z":"z"},{"y":-2}]');
+
+        // An object changing the shape of the next one while it is serialized
+        var records = [{ a: 1, b: null }, { a: 2, b: null }];
+        records[0].b = { toJSON: function () { records[1].a = 'changed'; delete records[1].b; records[1].c = 3; return 'b'; } };
+        expect(JSON.stringify(records)).toEqual('[{"a":1,"b":"b"},{"a":"changed","c":3}]');
+
+        Object.defineProperty(points[3], 'hidden', { value: 1, enumerable: false });
+        expect(JSON.stringify(points[3])).toEqual('{"x":3,"y":-3}');
+    });
+
+    it("should run with the DFG JIT, or refuse --dfg-jit in builds without it", function() {
+        var fs = require('fs'),
+            script = fs.absolute("dfg-jit-spec.js"),
+            run;
+
+        fs.write(script, [
+            "function mix(a, b) { return (a * 31 + b) | 0; }",
+            "var h = 0;",
+            "for (var i = 0; i < 1000000; ++i) h = mix(h, i);",
+            "console.log(h);",
+            "phantom.exit(0);"
+        ].join("\n"), "w");
+
+        run = runPhantom(["--dfg-jit=true"], script);
+
+        waitsFor(function() {
+            return run.exitCode !== null;
+        }, "the DFG JIT run to exit", 30000);
+
+        runs(function() {
+            var h = 0;
+            for (var i = 0; i < 1000000; ++i) h = (h * 31 + i) | 0;
+            if (run.exitCode === 0) {
+                expect(run.output.trim()).toEqual(String(h));
+            } else {
+                expect(run.errors).toContain("Unavailable option 'dfg-jit'");
+                expect(run.output).toEqual("");
+            }
+            fs.remove(script);
+        });
+    });
+
     it("should not crash when failing to dirty lines while removing a inline.", function () {
         var p = require("webpage").create();
         p.open('../test/webkit-spec/inline-destroy-dirty-lines-crash.html');
         waits(50);
     });
 });
+
+describe("JavaScript heap marking", function() {
+    var fs = require('fs'),
+        stressScript = fs.absolute("gc-stress-spec.js");
+
+    // Builds object graphs wide and deep enough to be shared between marking threads,
+    // collects a few times while they are alive, then checks that nothing was lost.
+    var stressSource = [
+        "var page = require('webpage').create();",
+        "function tree(depth) {",
+        "    if (!depth) return { leaf: 1 };",
+        "    return { left: tree(depth - 1), right: tree(depth - 1), items: [depth, 'x' + depth] };",
+        "}",
+        "function count(node) {",
+        "    return node.leaf ? 1 : count(node.left) + count(node.right);",
+        "}",
+        "var trees = [], closures = [];",
+        "for (var i = 0; i < 8; ++i) {",
+        "    trees.push(tree(12));",
+        "    closures.push((function (n) { var data = new Array(1000).join('.'); return function () { return n + data.length; }; })(i));",
+        "}",
+        "var domCount = page.evaluate(function () {",
+        "    // DOM wrappers are kept alive through opaque roots",
+        "    for (var i = 0; i < 2000; ++i) {",
+        "        var div = document.createElement('div');",
+        "        div.expando = { index: i };",
+        "        document.body.appendChild(div);",
+        "    }",
+        "    return document.body.childNodes.length;",
+        "});",
+        "var stats;",
+        "for (var round = 0; round < 10; ++round) {",
+        "    new Array(20000).join('garbage').split('a');",
+        "    stats = phantom.gc();",
+        "}",
+        "var leaves = 0, sum = 0;",
+        "trees.forEach(function (t) { leaves += count(t); });",
+        "closures.forEach(function (f) { sum += f(); });",
+        "var expandos = page.evaluate(function () {",
+        "    var total = 0, divs = document.body.childNodes;",
+        "    for (var i = 0; i < divs.length; ++i) total += divs[i].expando.index;",
+        "    return total;",
+        "});",
+        "console.log(JSON.stringify({ leaves: leaves, sum: sum, domCount: domCount, expandos: expandos,",
+        "    markingThreads: stats.markingThreads, lastMarkingTime: stats.lastMarkingTime }));",
+        "phantom.exit(0);"
+    ].join("\n");
+
+    function runStress(markingThreads) {
+        return runPhantom(["--gc-marking-threads=" + markingThreads], stressScript);
+    }
+
+    it("should keep every reachable object alive with one or more marking threads", function() {
+        var serial, parallel;
+
+        fs.write(stressScript, stressSource, "w");
+        serial = runStress(1);
+        parallel = runStress(4);
+
+        waitsFor(function() {
+            return serial.exitCode !== null && parallel.exitCode !== null;
+        }, "both stress runs to exit", 60000);
+
+        runs(function() {
+            var checked = [serial];
+            // Builds without ENABLE_PARALLEL_GC refuse more than one marking thread
+            if (parallel.exitCode === 0) {
+                checked.push(parallel);
+                expect(JSON.parse(parallel.output).markingThreads).toEqual(4);
+            } else {
+                expect(parallel.errors).toContain("Unavailable option 'gc-marking-threads' above 1");
+            }
+            checked.forEach(function (run) {
+                var stats = JSON.parse(run.output);
+                expect(run.exitCode).toEqual(0);
+                expect(stats.leaves).toEqual(8 * 4096);
+                expect(stats.sum).toEqual(28 + 8 * 999);
+                expect(stats.domCount).toEqual(2000);
+                expect(stats.expandos).toEqual(1999 * 2000 / 2);
+                expect(typeof stats.lastMarkingTime).toEqual('number');
+            });
+            expect(JSON.parse(serial.output).markingThreads).toEqual(1);
+            fs.remove(stressScript);
+        });
+    });
+
+    it("should keep young objects reachable only from old ones alive through minor collections", function() {
+        var generational;
+
+        fs.write(stressScript, [
+            "var old = [], oldGlobal = null;",
+            "for (var i = 0; i < 100; ++i) old.push({ slot: null, items: [] });",
+            "var scoped = (function () {",
+            "    var captured = null;",
+            "    return { set: function (v) { captured = v; }, get: function () { return captured; } };",
+            "})();",
+            "// Whatever survives a full collection is old",
+            "phantom.gc();",
+            "var minorCollections = phantom.heapStatistics.minorCollections;",
+            "for (var round = 0; round < 50; ++round) {",
+            "    for (var i = 0; i < old.length; ++i) {",
+            "        old[i].slot = { round: round, index: i };",
+            "        old[i].items[round] = { value: round * i };",
+            "    }",
+            "    oldGlobal = { round: round };",
+            "    scoped.set({ round: round });",
+            "    // Enough garbage for allocation to trigger collections",
+            "    for (var j = 0; j < 20000; ++j) { var garbage = { index: j, text: 'x' + j }; }",
+            "}",
+            "var ok = oldGlobal.round === 49 && scoped.get().round === 49;",
+            "for (var i = 0; i < old.length; ++i) {",
+            "    ok = ok && old[i].slot.round === 49 && old[i].slot.index === i;",
+            "    for (var round = 0; round < 50; ++round) ok = ok && old[i].items[round].value === round * i;",
+            "}",
+            "var stats = phantom.heapStatistics;",
+            "console.log(JSON.stringify({ ok: ok, generational: stats.generational,",
+            "    minorCollections: stats.minorCollections - minorCollections }));",
+            "phantom.exit(0);"
+        ].join("\n"), "w");
+
+        generational = runPhantom(["--gc-generational=true"], stressScript);
+
+        waitsFor(function() {
+            return generational.exitCode !== null;
+        }, "the generational run to exit", 60000);
+
+        runs(function() {
+            var result;
+            // Builds without ENABLE_GGC refuse to run rather than collect the whole heap
+            if (generational.exitCode !== 0) {
+                expect(generational.errors).toContain("Unavailable option 'gc-generational'");
+                expect(generational.output).toEqual("");
+            } else {
+                result = JSON.parse(generational.output);
+                expect(result.ok).toBeTruthy();
+                expect(result.generational).toBeTruthy();
+                expect(result.minorCollections).toBeGreaterThan(0);
+            }
+            fs.remove(stressScript);
+        });
+    });
+});
+
+describe("Script parser cache", function() {
+    var fs = require('fs'),
+        cacheDir = fs.absolute("script-cache-spec"),
+        pageFile = fs.absolute("script-cache-spec.html"),
+        libFile = fs.absolute("script-cache-spec-lib.js"),
+        runnerScript = fs.absolute("script-cache-spec-runner.js");
+
+    // Functions with bodies long enough for the parser to cache them
+    var libSource = [
+        "function sumOfSquares(values) {",
+        "    var total = 0;",
+        "    for (var i = 0; i < values.length; ++i) { total += values[i] * values[i]; }",
+        "    return total;",
+        "}",
+        "var joinWords = function (words, separator) {",
+        "    var result = '';",
+        "    for (var i = 0; i < words.length; ++i) { result += (i ? separator : '') + words[i]; }",
+        "    return result;",
+        "};",
+        "document.title = joinWords(['sum', String(sumOfSquares([1, 2, 3, 4]))], '=');"
+    ].join("\n");
+
+    // Waits past the delay after which the cache is written
+    var runnerSource = [
+        "var page = require('webpage').create();",
+        "page.open(" + JSON.stringify("file://" + pageFile) + ", function () {",
+        "    setTimeout(function () {",
+        "        console.log(page.title);",
+        "        phantom.exit(0);",
+        "    }, 1500);",
+        "});"
+    ].join("\n");
+
+    function runAndWait(description) {
+        var result = null;
+        runs(function() {
+            result = runPhantom(["--script-cache-path=" + cacheDir], runnerScript);
+        });
+        waitsFor(function() {
+            return result.exitCode !== null;
+        }, description, 15000);
+        return function () {
+            return result;
+        };
+    }
+
+    function cacheFiles() {
+        return fs.list(cacheDir).filter(function (name) {
+            return name !== "." && name !== "..";
+        });
+    }
+
+    it("should write the cache, read it back and survive a corrupt file", function() {
+        var first, second, third, cacheFile, cacheSize;
+
+        fs.write(libFile, libSource, "w");
+        fs.write(pageFile, "<html><head><script src='script-cache-spec-lib.js'></script></head><body></body></html>", "w");
+        fs.write(runnerScript, runnerSource, "w");
+        if (fs.exists(cacheDir)) {
+            fs.removeTree(cacheDir);
+        }
+
+        // Encode: the first run parses the functions and writes what it learned
+        first = runAndWait("the first run to exit");
+
+        runs(function() {
+            expect(first().exitCode).toEqual(0);
+            expect(first().output).toEqual("sum=30\n");
+            expect(cacheFiles().length).toEqual(1);
+            cacheFile = cacheDir + "/" + cacheFiles()[0];
+            cacheSize = fs.size(cacheFile);
+            // A SHA-1 of the script, then at least the version and item count
+            expect(cacheSize).toBeGreaterThan(28);
+        });
+
+        // Decode: the second run skips the cached function bodies, so has nothing to add
+        second = runAndWait("the second run to exit");
+
+        runs(function() {
+            expect(second().exitCode).toEqual(0);
+            expect(second().output).toEqual("sum=30\n");
+            expect(fs.size(cacheFile)).toEqual(cacheSize);
+
+            // Keep the digest of the script, so that the file is read, but make its only
+            // item point past the end of the script
+            var bytes = fs.readBytes(cacheFile), corrupt = [], i;
+            for (i = 0; i < 20; ++i) {
+                corrupt.push(bytes[i]);
+            }
+            [1, 1, 0, 1, 999999].forEach(function (value) {
+                corrupt.push(value & 0xff, (value >> 8) & 0xff, (value >> 16) & 0xff, (value >> 24) & 0xff);
+            });
+            corrupt.push(0, 0, 0, 0, 0, 0, 0, 0, 0);
+            fs.writeBytes(cacheFile, new Uint8Array(corrupt));
+        });
+
+        // A corrupt file is ignored, then replaced by a good one
+        third = runAndWait("the run with a corrupt cache to exit");
+
+        runs(function() {
+            expect(third().exitCode).toEqual(0);
+            expect(third().output).toEqual("sum=30\n");
+            expect(fs.size(cacheFile)).toEqual(cacheSize);
+
+            fs.removeTree(cacheDir);
+            fs.remove(libFile);
+            fs.remove(pageFile);
+            fs.remove(runnerScript);
+        });
+    });
+});
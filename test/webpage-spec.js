@@ -201,6 +201,8 @@ describe("WebPage object", function() {
     expectHasFunction(page, 'deleteLater');
     expectHasFunction(page, 'destroyed');
     expectHasFunction(page, 'evaluate');
+    expectHasFunction(page, 'compile');
+    expectHasFunction(page, 'reset');
     expectHasFunction(page, 'initialized');
     expectHasFunction(page, 'injectJs');
     expectHasFunction(page, 'javaScriptAlertSent');
@@ -215,6 +217,9 @@ describe("WebPage object", function() {
     expectHasFunction(page, 'resourceRequested');
     expectHasFunction(page, 'resourceError');
     expectHasFunction(page, 'uploadFile');
+    expectHasFunction(page, 'startProfiling');
+    expectHasFunction(page, 'stopProfiling');
+    expectHasFunction(page, 'memoryStats');
     expectHasFunction(page, 'sendEvent');
     expectHasFunction(page, 'childFramesCount');
     expectHasFunction(page, 'childFramesName');
@@ -568,6 +573,128 @@ describe("WebPage object", function() {
         });
     });
 
+    it("should invoke compiled functions with structured arguments", function() {
+        runs(function() {
+            var sum = page.compile(function (values, offset) {
+                var total = offset;
+                for (var i = 0; i < values.length; ++i) {
+                    total += values[i].n;
+                }
+                return total;
+            });
+
+            expect(sum([{n: 1}, {n: 2}], 10)).toEqual(13);
+            expect(sum([{n: 5}], 0)).toEqual(5);
+
+            // The store stays out of enumerations and of accidental assignments
+            expect(page.evaluate(function () {
+                var names = [];
+                for (var name in window) {
+                    names.push(name);
+                }
+                window._phantomCompiled = null;
+                return names.indexOf("_phantomCompiled");
+            })).toEqual(-1);
+            expect(sum([{n: 5}], 1)).toEqual(6);
+
+            page.setContent("<html><body></body></html>", "http://www.phantomjs.org/");
+            expect(sum([{n: 4}], 1)).toEqual(5);
+
+            sum.release();
+            expect(sum([{n: 4}], 1)).toBeFalsy();
+        });
+    });
+
+    it("should run a compiled function that throws only once", function() {
+        runs(function() {
+            var failing = page.compile(function () {
+                window.compiledCalls = (window.compiledCalls || 0) + 1;
+                throw new Error("compiled function failure");
+            });
+
+            page.setContent("<html><body></body></html>", "http://www.phantomjs.org/");
+            expect(failing()).toBeFalsy();
+            expect(page.evaluate(function () { return window.compiledCalls; })).toEqual(1);
+            expect(failing()).toBeFalsy();
+            expect(page.evaluate(function () { return window.compiledCalls; })).toEqual(2);
+            failing.release();
+        });
+    });
+
+    it("should transfer typed arrays as raw bytes", function() {
+        runs(function() {
+            var bytes = page.evaluate(function () {
+                var data = new Uint8Array(4);
+                data[0] = 0; data[1] = 1; data[2] = 128; data[3] = 255;
+                return data;
+            });
+
+            expect(bytes.length).toEqual(4);
+            expect(bytes[0]).toEqual(0);
+            expect(bytes[2]).toEqual(128);
+            expect(bytes[3]).toEqual(255);
+        });
+    });
+
+    it("should reset the page for reuse", function() {
+        runs(function() {
+            var p = require('webpage').create();
+
+            p.onLoadFinished = function () {};
+            p.viewportSize = { width: 800, height: 600 };
+            p.customHeaders = { 'X-Test': 'foo' };
+            p.settings.userAgent = 'Reset Test';
+            p.setContent('<html><body><script>window.leftover = 42;</script></body></html>', 'http://www.phantomjs.org/');
+            expect(p.evaluate(function () { return window.leftover; })).toEqual(42);
+
+            p.reset();
+
+            expect(p.onLoadFinished).toBeUndefined();
+            expect(typeof p.onError).toEqual('function');
+            expect(p.viewportSize).toEqual({ width: 400, height: 300 });
+            expect(p.customHeaders).toEqual({});
+            expect(p.settings.userAgent).toEqual(phantom.defaultPageSettings.userAgent);
+            expect(p.evaluate(function () { return typeof window.leftover; })).toEqual('undefined');
+            expect(p.canGoBack).toBeFalsy();
+            // Same document, same origin as a fresh page
+            var fresh = require('webpage').create();
+            expect(p.url).toEqual(fresh.url);
+            expect(p.evaluate(function () { return location.href; })).toEqual(fresh.evaluate(function () { return location.href; }));
+            fresh.close();
+
+            var pool = require('webpage').createPool();
+            pool.release(p);
+            expect(pool.acquire()).toBe(p);
+            pool.close();
+        });
+    });
+
+    it("should keep a page released twice in its pool once, and close pages over the pool size", function() {
+        var pool = require('webpage').createPool({}, 1),
+            first = pool.acquire(),
+            second = pool.acquire(),
+            closing = jasmine.createSpy("onClosing spy");
+
+        expect(second).not.toBe(first);
+        pool.release(first);
+        pool.release(first);
+        second.onClosing = closing;
+        pool.release(second);
+
+        waitsFor(function() {
+            return closing.callCount > 0;
+        }, "the page over the pool size to be closed", 2000);
+
+        runs(function() {
+            var again = pool.acquire(), another = pool.acquire();
+            expect(again).toBe(first);
+            expect(another).not.toBe(first);
+            another.close();
+            again.close();
+            pool.close();
+        });
+    });
+
     it("reports unhandled errors", function() {
         var lastError = null;
 
@@ -1307,6 +1434,84 @@ describe("WebPage object", function() {
             server.close();
         });
     });
+
+    it("should profile the JavaScript run by the page", function() {
+        var page = require('webpage').create();
+
+        runs(function() {
+            expect(page.startProfiling(1)).toBe(true);
+            expect(page.startProfiling(1)).toBe(false);
+        });
+
+        waits(100);
+
+        runs(function() {
+            page.evaluate(function() {
+                function spin(until) {
+                    while (Date.now() < until) {}
+                }
+                spin(Date.now() + 100);
+            });
+            var profile = page.stopProfiling();
+            expect(profile.nodes.length).toBeGreaterThan(1);
+            expect(profile.nodes[0].callFrame.functionName).toEqual('(root)');
+            expect(profile.samples.length).toEqual(profile.timeDeltas.length);
+            page.close();
+        });
+    });
+
+    it("should report the memory held by the page", function() {
+        var page = require('webpage').create();
+        page.setContent('<html><body><div><p>one</p><p>two</p></div></body></html>', 'http://localhost/');
+
+        var stats = page.memoryStats();
+        expect(stats.jsHeap.size).toBeGreaterThan(0);
+        expect(stats.page.frames).toEqual(1);
+        expect(stats.page.domNodes).toBeGreaterThan(6);
+        expect(stats.page.images.count).toEqual(0);
+        page.close();
+    });
+
+    it("should decode ahead only the images it is about to paint, and not again once purged", function() {
+        var page = require('webpage').create(),
+            renderFile = "webpage-spec-renders/temp_decode_ahead.png",
+            // phantomjs.png is 200x200: its frame takes 160000 bytes
+            frameBytes = 200 * 200 * 4;
+
+        page.viewportSize = { width: 300, height: 300 };
+        // The 300x300 image created by the script is never displayed
+        page.setContent('<html><body><img src="phantomjs.png">' +
+            '<script>var hidden = new Image(); hidden.src = "webpage-spec-renders/test.png";</script></body></html>',
+            'file://' + fs.workingDirectory + '/');
+
+        waits(500);
+
+        runs(function() {
+            // Nothing has been painted: the displayed image is being decoded, and accounted for
+            var images = page.memoryStats().page.images;
+            expect(images.count).toEqual(2);
+            expect(images.decodedSize).toEqual(frameBytes);
+        });
+
+        // Live decoded data younger than a second is not pruned
+        waits(1100);
+
+        runs(function() {
+            phantom.pruneMemoryCache(0);
+            expect(page.memoryStats().page.images.decodedSize).toEqual(0);
+        });
+
+        waits(300);
+
+        runs(function() {
+            // The decoder recreated by the purge waits for the image to be painted
+            expect(page.memoryStats().page.images.decodedSize).toEqual(0);
+            page.render(renderFile);
+            fs.remove(renderFile);
+            expect(page.memoryStats().page.images.decodedSize).toEqual(frameBytes);
+            page.close();
+        });
+    });
 });
 
 describe("WebPage construction with options", function () {
@@ -2194,3 +2399,240 @@ describe("WebPage network request headers handling", function() {
         });
     });
 });
+
+describe("WebPage resource load scheduling", function() {
+    it("should have default scheduling settings", function() {
+        var p = require("webpage").create();
+        expect(p.settings.maxRequestsPerHost).toEqual(0);
+        expect(p.settings.resourcePriorities).toEqual([]);
+        p.close();
+    });
+
+    it("should load every resource with a per-host limit and priority rules", function() {
+        var p = require("webpage").create(),
+            server = require("webserver").create(),
+            requested = [],
+            loadStatus = null;
+
+        server.listen(12345, function(request, response) {
+            response.statusCode = 200;
+            if (request.url === "/") {
+                response.write('<html><head>' +
+                    '<script src="/deferred.js"></script>' +
+                    '<link rel="stylesheet" href="/style.css">' +
+                    '</head><body><img src="/a.png"><img src="/b.png"></body></html>');
+            }
+            response.close();
+        });
+
+        p.settings.maxRequestsPerHost = 1;
+        p.settings.resourcePriorities = [
+            { url: "deferred\\.js$", priority: "defer" },
+            { type: "stylesheet", priority: "high" },
+            { type: "image", priority: "medium" }
+        ];
+        p.onResourceRequested = function(requestData) {
+            requested.push(requestData.url.replace("http://localhost:12345", ""));
+        };
+
+        runs(function() {
+            p.open("http://localhost:12345/", function(status) {
+                loadStatus = status;
+            });
+        });
+
+        waitsFor(function() {
+            return loadStatus !== null;
+        }, "the page to load", 5000);
+
+        runs(function() {
+            expect(loadStatus).toEqual("success");
+            expect(requested.sort()).toEqual(["/", "/a.png", "/b.png", "/deferred.js", "/style.css"]);
+            p.close();
+            server.close();
+        });
+    });
+
+    it("should only hold back the loads of the page at its limit", function() {
+        var limited = require("webpage").create(),
+            other = require("webpage").create(),
+            server = require("webserver").create(),
+            limitedStatus = null,
+            otherStatus = null;
+
+        server.listen(12346, function(request, response) {
+            response.statusCode = 200;
+            if (request.url === "/limited") {
+                response.write('<html><body><img src="/slow1.png"><img src="/slow2.png"></body></html>');
+            } else if (request.url === "/other") {
+                response.write('<html><body><img src="/fast.png"></body></html>');
+            } else if (request.url.indexOf("/slow") === 0) {
+                setTimeout(function () {
+                    response.close();
+                }, 3000);
+                return;
+            }
+            response.close();
+        });
+
+        limited.settings.maxRequestsPerHost = 1;
+
+        runs(function() {
+            limited.open("http://localhost:12346/limited", function(status) {
+                limitedStatus = status;
+            });
+        });
+
+        // Let the limited page fill its single slot, and queue its second image
+        waits(500);
+
+        runs(function() {
+            other.open("http://localhost:12346/other", function(status) {
+                otherStatus = status;
+            });
+        });
+
+        waitsFor(function() {
+            return otherStatus !== null;
+        }, "the other page to load while the limited one waits", 2000);
+
+        runs(function() {
+            expect(otherStatus).toEqual("success");
+            expect(limitedStatus).toBeNull();
+        });
+
+        waitsFor(function() {
+            return limitedStatus !== null;
+        }, "the limited page to load", 10000);
+
+        runs(function() {
+            expect(limitedStatus).toEqual("success");
+            limited.close();
+            other.close();
+            server.close();
+        });
+    });
+});
+
+describe("WebPage load completion signals", function() {
+    it("should have default completion times", function() {
+        var p = require("webpage").create();
+        expect(p.settings.networkIdleTime).toEqual(500);
+        expect(p.settings.visuallyCompleteTime).toEqual(500);
+        p.close();
+    });
+
+    it("should call 'onNetworkIdle' and 'onVisuallyComplete' after the page loads", function() {
+        var p = require("webpage").create(),
+            server = require("webserver").create(),
+            events = [];
+
+        server.listen(12345, function(request, response) {
+            response.statusCode = 200;
+            response.write('<html><body><p>Done</p></body></html>');
+            response.close();
+        });
+
+        p.settings.networkIdleTime = 100;
+        p.settings.visuallyCompleteTime = 100;
+        p.onLoadFinished = function() {
+            events.push("loadFinished");
+        };
+        p.onNetworkIdle = function() {
+            events.push("networkIdle");
+        };
+        p.onVisuallyComplete = function() {
+            events.push("visuallyComplete");
+        };
+
+        runs(function() {
+            p.open("http://localhost:12345/");
+        });
+
+        waitsFor(function() {
+            return events.indexOf("networkIdle") !== -1 && events.indexOf("visuallyComplete") !== -1;
+        }, "both completion signals", 5000);
+
+        runs(function() {
+            expect(events.indexOf("loadFinished")).toBeLessThan(events.indexOf("visuallyComplete"));
+            expect(events.filter(function(e) { return e === "visuallyComplete"; }).length).toEqual(1);
+            p.close();
+            server.close();
+        });
+    });
+});
+
+describe("Oversized image decoding", function() {
+    var fs = require('fs'),
+        imageScript = fs.absolute("max-decoded-image-area-spec.js");
+
+    // Paints phantomjs.png, 200x200, at half its size then at its own size, and
+    // reports what its decoded frame takes after each
+    var imageSource = [
+        "var page = require('webpage').create();",
+        "page.viewportSize = { width: 400, height: 300 };",
+        "page.setContent('<html><body><img src=\"phantomjs.png\" width=\"100\" height=\"100\"></body></html>', " +
+            JSON.stringify("file://" + fs.workingDirectory + "/") + ");",
+        "setTimeout(function () {",
+        "    page.renderBase64('png');",
+        "    console.log(page.memoryStats().page.images.decodedSize);",
+        "    page.evaluate(function () {",
+        "        var image = document.createElement('img');",
+        "        image.src = 'phantomjs.png';",
+        "        document.body.appendChild(image);",
+        "    });",
+        "    setTimeout(function () {",
+        "        page.renderBase64('png');",
+        "        console.log(page.memoryStats().page.images.decodedSize);",
+        "        phantom.exit(0);",
+        "    }, 200);",
+        "}, 500);"
+    ].join("\n");
+
+    it("should decode images scaled down, but never smaller than they are drawn", function() {
+        var full, scaled;
+
+        fs.write(imageScript, imageSource, "w");
+        full = runPhantom(["--max-decoded-image-area=0"], imageScript);
+        // A quarter of the pixels: 100x100, as long as it is drawn no larger
+        scaled = runPhantom(["--max-decoded-image-area=10000"], imageScript);
+
+        waitsFor(function() {
+            return full.exitCode !== null && scaled.exitCode !== null;
+        }, "both runs to exit", 15000);
+
+        runs(function() {
+            expect(full.exitCode).toEqual(0);
+            expect(scaled.exitCode).toEqual(0);
+            expect(full.output).toEqual([200 * 200 * 4, 200 * 200 * 4, ""].join("\n"));
+            // Decoded again at its own size once drawn at it
+            expect(scaled.output).toEqual([100 * 100 * 4, 200 * 200 * 4, ""].join("\n"));
+            fs.remove(imageScript);
+        });
+    });
+});
+
+describe("Memory cache size options", function() {
+    var fs = require('fs'),
+        statsScript = fs.absolute("memory-cache-size-spec.js");
+
+    it("should cap sizes that do not fit the cache", function() {
+        var large;
+
+        fs.write(statsScript, "console.log(JSON.stringify(phantom.memoryStats().memoryCache));\nphantom.exit(0);", "w");
+        // 4 GB in KB, which overflowed to 0 when converted to bytes
+        large = runPhantom(["--memory-cache-size=4194304", "--memory-cache-dead-size=4194304"], statsScript);
+
+        waitsFor(function() {
+            return large.exitCode !== null;
+        }, "the run to exit", 15000);
+
+        runs(function() {
+            var stats = JSON.parse(large.output);
+            expect(large.exitCode).toEqual(0);
+            expect(stats.capacity).toEqual(2147483647);
+            expect(stats.maxDeadCapacity).toEqual(2147483647);
+            fs.remove(statsScript);
+        });
+    });
+});